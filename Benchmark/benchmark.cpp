@@ -0,0 +1,471 @@
+// benchmark.cpp : Parameterized benchmarks of math_algorithm.h routines at production scales.
+//
+// Usage:
+//		Benchmark [--filter=<substring>] [--scale=quick|production] [--repetitions=<n>]
+//				  [--format=json|csv] [--output=<file>] [--list]
+//
+// Results are written in a machine-readable form (JSON by default, CSV on demand) so that
+// optimizations can be verified and regressions caught by comparing two runs.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#pragma warning(disable: 4996)
+
+#include "../Math/matrix.h"
+#include "../Math/math_algorithm.h"
+
+namespace {
+
+	/// <summary> Benchmark scale, production scale contains the largest (slow) shapes. </summary>
+	enum class Scale {
+		Quick,
+		Production
+	};
+
+	/// <summary> A single parameterized benchmark case. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	struct BenchmarkCase {
+		std::string name;								// Routine name
+		std::string params;								// Parameters, formatted as "key=value,key=value"
+		double items;									// Processed items per iteration (for throughput)
+		std::function<std::function<double()>()> setup;	// Prepare input, return the measured body
+	};
+
+	/// <summary> Measured statistics of a benchmark case. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	struct BenchmarkResult {
+		std::string name;
+		std::string params;
+		size_t repetitions;
+		double min_ns;
+		double median_ns;
+		double mean_ns;
+		double stddev_ns;
+		double items_per_second;
+		double checksum;
+	};
+
+	/// <summary> Benchmark options parsed from command line. </summary>
+	struct Options {
+		std::string filter;
+		Scale scale = Scale::Quick;
+		size_t repetitions = 5;
+		std::string format = "json";
+		std::string output;
+		bool list = false;
+	};
+
+	// Keep the optimizer from discarding the measured body
+	volatile double benchmark_sink = 0.0;
+
+	/// <summary> Deterministic input generator, identical between runs. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	class InputGenerator {
+	public:
+		explicit InputGenerator(const unsigned seed = 20200323u) : generator_(seed) {}
+
+		/// <summary> Strictly increasing abscissa in [0, span). </summary>
+		std::vector<double> Abscissa(const size_t n, const double span = 86400.0) {
+			std::vector<double> x(n);
+			const double step = span / static_cast<double>(n);
+			for (size_t i = 0; i < n; i++)
+				x[i] = step * static_cast<double>(i);
+			return x;
+		}
+
+		/// <summary> Smooth signal with gaussian noise and sparse outliers. </summary>
+		std::vector<double> Signal(const std::vector<double>& x, const double noise = 0.01,
+								   const double outlier_rate = 0.001) {
+			std::normal_distribution<double> normal(0.0, noise);
+			std::uniform_real_distribution<double> uniform(0.0, 1.0);
+			std::vector<double> y(x.size());
+			for (size_t i = 0; i < x.size(); i++) {
+				y[i] = std::sin(x[i] * 7.27e-5) + 0.3 * std::cos(x[i] * 1.45e-4) + normal(generator_);
+				if (uniform(generator_) < outlier_rate)
+					y[i] += 50.0 * noise;
+			}
+			return y;
+		}
+
+		/// <summary> Zero mean noise with sparse outliers. </summary>
+		std::vector<double> Residual(const size_t n, const double noise = 1.0, const double outlier_rate = 0.01) {
+			std::vector<double> x(n, 0.0);
+			return Signal(x, noise, outlier_rate);
+		}
+
+	private:
+		std::mt19937 generator_;
+	};
+
+	/// <summary> Format parameters. </summary>
+	std::string Params(const std::vector<std::pair<std::string, size_t>>& params) {
+		std::ostringstream ss;
+		for (size_t i = 0; i < params.size(); i++) {
+			if (i != 0)
+				ss << ',';
+			ss << params[i].first << '=' << params[i].second;
+		}
+		return ss.str();
+	}
+
+	/// <summary> Register all benchmark cases for given scale. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	std::vector<BenchmarkCase> RegisterCases(const Scale scale) {
+		using namespace NUDTTK::Math;
+		const bool production = scale == Scale::Production;
+		std::vector<BenchmarkCase> cases;
+
+		// Vondrak filter, 10^4 ~ 10^7 observations
+		std::vector<size_t> vondrak_sizes = { 10000, 100000, 1000000 };
+		if (production)
+			vondrak_sizes.push_back(10000000);
+		for (size_t n : vondrak_sizes) {
+			cases.push_back({ "VandrakFilter", Params({ {"n", n} }), static_cast<double>(n),
+							[n]() -> std::function<double()> {
+				InputGenerator generator;
+				auto x = std::make_shared<std::vector<double>>(generator.Abscissa(n));
+				auto y = std::make_shared<std::vector<double>>(generator.Signal(*x));
+				auto w = std::make_shared<std::vector<double>>(n, 1.0);
+				auto y_fit = std::make_shared<std::vector<double>>(n, 0.0);
+				return [=]() {
+					VandrakFilter(x->data(), y->data(), w->data(), n, 1e-10, y_fit->data());
+					return (*y_fit)[n / 2];
+				};
+			} });
+		}
+
+		// Kinematic robust Vondrak filter, dynamic noise window 31 ~ 1001
+		std::vector<size_t> kinematic_sizes = { 10000 };
+		if (production)
+			kinematic_sizes.push_back(100000);
+		for (size_t n : kinematic_sizes) {
+			for (size_t nwidth : { 31, 101, 1001 }) {
+				cases.push_back({ "KinematicRobustVandrakFilter",
+								Params({ {"n", n}, {"window", nwidth} }),
+								static_cast<double>(n), [n, nwidth]() -> std::function<double()> {
+					InputGenerator generator;
+					auto x = std::make_shared<std::vector<double>>(generator.Abscissa(n));
+					auto y = std::make_shared<std::vector<double>>(generator.Signal(*x));
+					auto w = std::make_shared<std::vector<double>>(n, 1.0);
+					auto y_fit = std::make_shared<std::vector<double>>(n, 0.0);
+					return [=]() {
+						std::fill(w->begin(), w->end(), 1.0);
+						KinematicRobustVandrakFilter(x->data(), y->data(), w->data(), n, 1e-10, y_fit->data(),
+													 1.0, 0.001, nwidth);
+						return (*y_fit)[n / 2];
+					};
+				} });
+			}
+		}
+
+		// Polynomial fit, typical sliding window sizes and orders
+		std::vector<size_t> poly_sizes = { 100, 1000, 10000 };
+		if (production)
+			poly_sizes.push_back(100000);
+		for (size_t n : poly_sizes) {
+			for (size_t m : { 3, 8 }) {
+				const auto params = Params({ {"n", n}, {"m", m} });
+				cases.push_back({ "PolyFit", params, static_cast<double>(n), [n, m]() -> std::function<double()> {
+					InputGenerator generator;
+					auto x = std::make_shared<std::vector<double>>(generator.Abscissa(n, 2.0));
+					auto y = std::make_shared<std::vector<double>>(generator.Signal(*x));
+					auto y_fit = std::make_shared<std::vector<double>>(n, 0.0);
+					return [=]() {
+						PolyFit(x->data(), y->data(), n, y_fit->data(), m);
+						return (*y_fit)[n / 2];
+					};
+				} });
+				cases.push_back({ "RobustPolyFit", params, static_cast<double>(n), [n, m]() -> std::function<double()> {
+					InputGenerator generator;
+					auto x = std::make_shared<std::vector<double>>(generator.Abscissa(n, 2.0));
+					auto y = std::make_shared<std::vector<double>>(generator.Signal(*x));
+					auto w = std::make_shared<std::vector<double>>(n, 1.0);
+					auto y_fit = std::make_shared<std::vector<double>>(n, 0.0);
+					return [=]() {
+						RobustPolyFit(x->data(), y->data(), w->data(), n, y_fit->data(), m);
+						return (*y_fit)[n / 2];
+					};
+				} });
+			}
+		}
+
+		// Normalized Legendre functions, gravity field degree 360 and 2190
+		for (size_t degree : { 360, 2190 }) {
+			for (bool derivative : { false, true }) {
+				const double items = static_cast<double>((degree + 1) * (degree + 2) / 2);
+				cases.push_back({ derivative ? "LegendreFuncDerivative" : "LegendreFunc",
+								Params({ {"degree", degree} }), items,
+								[degree, derivative]() -> std::function<double()> {
+					// Storage of [n + 1][n + 1] as required by the interface
+					auto p_storage = std::make_shared<std::vector<long double>>((degree + 1) * (degree + 1));
+					auto dp_storage = std::make_shared<std::vector<long double>>((degree + 1) * (degree + 1));
+					auto p = std::make_shared<std::vector<long double*>>(degree + 1);
+					auto dp = std::make_shared<std::vector<long double*>>(degree + 1);
+					for (size_t i = 0; i <= degree; i++) {
+						(*p)[i] = p_storage->data() + i * (degree + 1);
+						(*dp)[i] = dp_storage->data() + i * (degree + 1);
+					}
+					// Row pointers refer into the storage, keep it alive with the body
+					return [p_storage, dp_storage, p, dp, degree, derivative]() {
+						if (derivative)
+							LegendreFuncDerivative(p->data(), dp->data(), degree, 0.5);
+						else
+							LegendreFunc(p->data(), degree, 0.5);
+						return static_cast<double>((*p)[degree][degree / 2]);
+					};
+				} });
+			}
+		}
+
+		// Lagrange interpolation, typical orbit interpolation orders, 10^4 evaluations
+		for (size_t n : { 8, 12, 16 }) {
+			_CONSTEXPR size_t evaluations = 10000;
+			cases.push_back({ "InterploationLagrange", Params({ {"points", n},
+								{"evaluations", evaluations} }),
+							static_cast<double>(evaluations), [n]() -> std::function<double()> {
+				InputGenerator generator;
+				auto xa = std::make_shared<std::vector<double>>(generator.Abscissa(n, 300.0 * n));
+				auto ya = std::make_shared<std::vector<double>>(generator.Signal(*xa));
+				return [=]() {
+					double sum = 0.0, y = 0.0, dy = 0.0;
+					const double step = ((*xa)[n - 1] - (*xa)[0]) / evaluations;
+					for (size_t i = 0; i < evaluations; i++) {
+						InterploationLagrange(xa->data(), ya->data(), n, (*xa)[0] + step * i, y, dy);
+						sum += y + dy;
+					}
+					return sum;
+				};
+			} });
+		}
+
+		// Median, full series
+		std::vector<size_t> median_sizes = { 1001, 100001 };
+		if (production)
+			median_sizes.push_back(10000001);
+		for (size_t n : median_sizes) {
+			cases.push_back({ "Median", Params({ {"n", n} }), static_cast<double>(n),
+							[n]() -> std::function<double()> {
+				InputGenerator generator;
+				auto source = std::make_shared<std::vector<double>>(generator.Residual(n));
+				auto work = std::make_shared<std::vector<double>>(n);
+				return [=]() {
+					// Median changes the element order, restore the input every iteration
+					std::copy(source->begin(), source->end(), work->begin());
+					return Median(work->data(), n);
+				};
+			} });
+		}
+
+		// Sliding MAD, window 31 ~ 1001
+		const size_t mad_series = production ? 1000000 : 100000;
+		for (size_t nwidth : { 31, 101, 301, 1001 }) {
+			cases.push_back({ "Mad", Params({ {"n", mad_series}, {"window", nwidth} }),
+							static_cast<double>(mad_series - nwidth + 1), [mad_series, nwidth]() -> std::function<double()> {
+				InputGenerator generator;
+				auto residual = std::make_shared<std::vector<double>>(generator.Residual(mad_series));
+				return [=]() {
+					double sum = 0.0;
+					for (size_t i = 0; i + nwidth <= mad_series; i++)
+						sum += Mad(residual->data() + i, nwidth);
+					return sum;
+				};
+			} });
+		}
+
+		// Robust statistics
+		std::vector<size_t> robust_sizes = { 10000, 1000000 };
+		if (production)
+			robust_sizes.push_back(10000000);
+		for (size_t n : robust_sizes) {
+			cases.push_back({ "RobustStatRms", Params({ {"n", n} }), static_cast<double>(n),
+							[n]() -> std::function<double()> {
+				InputGenerator generator;
+				auto x = std::make_shared<std::vector<double>>(generator.Residual(n));
+				auto marker = std::make_shared<std::vector<double>>(n, 0.0);
+				return [=]() {
+					return RobustStatRms(x->data(), marker->data(), n);
+				};
+			} });
+			cases.push_back({ "RobustStatMean", Params({ {"n", n} }), static_cast<double>(n),
+							[n]() -> std::function<double()> {
+				InputGenerator generator;
+				auto x = std::make_shared<std::vector<double>>(generator.Residual(n));
+				auto w = std::make_shared<std::vector<double>>(n, 0.0);
+				return [=]() {
+					double mean = 0.0, var = 0.0;
+					RobustStatMean(x->data(), w->data(), n, mean, var);
+					return mean + var;
+				};
+			} });
+		}
+
+		return cases;
+	}
+
+	/// <summary> Run a benchmark case, one warm-up iteration and given repetitions. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	BenchmarkResult Run(const BenchmarkCase& benchmark_case, const size_t repetitions) {
+		auto body = benchmark_case.setup();
+		double checksum = body();	// Warm-up
+
+		std::vector<double> samples(repetitions, 0.0);
+		for (size_t i = 0; i < repetitions; i++) {
+			const auto start = std::chrono::steady_clock::now();
+			benchmark_sink = body();
+			const auto stop = std::chrono::steady_clock::now();
+			samples[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+		}
+
+		std::vector<double> sorted(samples);
+		std::sort(sorted.begin(), sorted.end());
+		const double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / repetitions;
+		double variance = 0.0;
+		for (double sample : samples)
+			variance += (sample - mean) * (sample - mean);
+		const double median = (repetitions & 1) ? sorted[repetitions / 2]
+			: (sorted[repetitions / 2 - 1] + sorted[repetitions / 2]) / 2.0;
+
+		BenchmarkResult result;
+		result.name = benchmark_case.name;
+		result.params = benchmark_case.params;
+		result.repetitions = repetitions;
+		result.min_ns = sorted.front();
+		result.median_ns = median;
+		result.mean_ns = mean;
+		result.stddev_ns = repetitions > 1 ? std::sqrt(variance / (repetitions - 1)) : 0.0;
+		result.items_per_second = median > 0.0 ? benchmark_case.items / (median * 1e-9) : 0.0;
+		result.checksum = checksum;
+		return result;
+	}
+
+	/// <summary> Write results in JSON. </summary>
+	void WriteJson(std::ostream& os, const Options& options, const std::vector<BenchmarkResult>& results) {
+		os.precision(17);
+		os << "{\n  \"context\": {\n"
+		   << "    \"library\": \"NUDTTK Math\",\n"
+		   << "    \"scale\": \"" << (options.scale == Scale::Production ? "production" : "quick") << "\",\n"
+		   << "    \"repetitions\": " << options.repetitions << ",\n"
+		   << "    \"eigen_version\": \"" << EIGEN_WORLD_VERSION << '.' << EIGEN_MAJOR_VERSION << '.'
+		   << EIGEN_MINOR_VERSION << "\",\n"
+		   << "    \"cplusplus\": " << __cplusplus << "\n  },\n  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const auto& result = results[i];
+			os << "    {\"name\": \"" << result.name << "\", \"params\": \"" << result.params << "\""
+			   << ", \"repetitions\": " << result.repetitions
+			   << ", \"min_ns\": " << result.min_ns
+			   << ", \"median_ns\": " << result.median_ns
+			   << ", \"mean_ns\": " << result.mean_ns
+			   << ", \"stddev_ns\": " << result.stddev_ns
+			   << ", \"items_per_second\": " << result.items_per_second
+			   << ", \"checksum\": " << result.checksum << "}"
+			   << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		os << "  ]\n}\n";
+	}
+
+	/// <summary> Write results in CSV. </summary>
+	void WriteCsv(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+		os.precision(17);
+		os << "name,params,repetitions,min_ns,median_ns,mean_ns,stddev_ns,items_per_second,checksum\n";
+		for (const auto& result : results) {
+			os << result.name << ",\"" << result.params << "\"," << result.repetitions << ','
+			   << result.min_ns << ',' << result.median_ns << ',' << result.mean_ns << ','
+			   << result.stddev_ns << ',' << result.items_per_second << ',' << result.checksum << '\n';
+		}
+	}
+
+	/// <summary> Parse command line arguments. </summary>
+	bool ParseOptions(int argc, char* argv[], Options& options) {
+		for (int i = 1; i < argc; i++) {
+			const std::string argument(argv[i]);
+			const auto value_of = [&argument](const char* key) -> const char* {
+				const size_t key_size = std::strlen(key);
+				return argument.compare(0, key_size, key) == 0 ? argument.c_str() + key_size : nullptr;
+			};
+			if (const char* value = value_of("--filter=")) {
+				options.filter = value;
+			} else if (const char* value = value_of("--scale=")) {
+				if (std::strcmp(value, "production") == 0)
+					options.scale = Scale::Production;
+				else if (std::strcmp(value, "quick") == 0)
+					options.scale = Scale::Quick;
+				else
+					return false;
+			} else if (const char* value = value_of("--repetitions=")) {
+				options.repetitions = static_cast<size_t>(std::strtoul(value, nullptr, 10));
+				if (options.repetitions == 0)
+					return false;
+			} else if (const char* value = value_of("--format=")) {
+				options.format = value;
+				if (options.format != "json" && options.format != "csv")
+					return false;
+			} else if (const char* value = value_of("--output=")) {
+				options.output = value;
+			} else if (argument == "--list") {
+				options.list = true;
+			} else {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: " << argv[0] << " [--filter=<substring>] [--scale=quick|production]"
+				  << " [--repetitions=<n>] [--format=json|csv] [--output=<file>] [--list]" << std::endl;
+		return 1;
+	}
+
+	std::vector<BenchmarkCase> cases;
+	for (auto& benchmark_case : RegisterCases(options.scale)) {
+		const std::string full_name = benchmark_case.name + "/" + benchmark_case.params;
+		if (options.filter.empty() || full_name.find(options.filter) != std::string::npos)
+			cases.push_back(std::move(benchmark_case));
+	}
+
+	if (options.list) {
+		for (const auto& benchmark_case : cases)
+			std::cout << benchmark_case.name << '/' << benchmark_case.params << std::endl;
+		return 0;
+	}
+
+	std::vector<BenchmarkResult> results;
+	for (const auto& benchmark_case : cases) {
+		// Progress goes to stderr, results stay machine-readable on stdout
+		std::cerr << "Running " << benchmark_case.name << '/' << benchmark_case.params << std::endl;
+		results.push_back(Run(benchmark_case, options.repetitions));
+	}
+
+	std::ofstream file;
+	if (!options.output.empty()) {
+		file.open(options.output);
+		if (!file) {
+			std::cerr << "Cannot open " << options.output << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& os = options.output.empty() ? std::cout : file;
+	if (options.format == "csv")
+		WriteCsv(os, results);
+	else
+		WriteJson(os, options, results);
+
+	return 0;
+}
@@ -0,0 +1,495 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_BLOCK_DIAGONAL_MATRIX_TR_
+#define _NUDTTK_MATH_BLOCK_DIAGONAL_MATRIX_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+#include "parallel.h"
+
+#include <vector>
+
+#if __cplusplus < 201103L
+#error You need to compile block matrices with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> A block-diagonal matrix bordered by dense rows and columns, e.g. the normal matrix of a
+	/// 	constellation with one block of parameters per satellite and a few global parameters: </para>
+	/// 	<code>
+	/// 	| D_0         B_0 |
+	/// 	|     D_1     B_1 |
+	/// 	|         ... ... |
+	/// 	| C_0 C_1 ... G   |
+	/// 	</code>
+	/// 	<para> Only the blocks are stored. <c>Solve</c>, <c>Inv</c> and <c>DetGauss</c> factorize
+	/// 	the diagonal blocks in parallel and the border through the Schur complement
+	/// 	<c>G - sum C_i D_i^-1 B_i</c>, the factorization is cached and shared by copies. If a diagonal
+	/// 	block is singular the bordered matrix may still be invertible, it is then factorized dense. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T = double>
+	class BlockDiagonalMatrix {
+	public:
+		typedef typename Matrix<_T>::base_type dense_type;
+
+	public:
+		/// <summary> Default constructor (no thing to do). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		BlockDiagonalMatrix() _NOEXCEPT {}
+
+		/// <summary> Initialize zero BlockDiagonalMatrix in block sizes and border size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="block_sizes"> Sizes of the square diagonal blocks. </param>
+		/// <param name="border_size"> (Optional) Number of the bordering rows and columns, default is 0. </param>
+		explicit BlockDiagonalMatrix(const std::vector<size_t>& block_sizes, const size_t border_size = 0)
+			: value_(MakeBlocks(block_sizes, border_size)) {}
+
+	public:
+		/// <summary> Gets number of the diagonal blocks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The number of blocks. </returns>
+		size_t GetNumBlocks() const _NOEXCEPT {
+			return value_->diagonal.size();
+		}
+
+		/// <summary> Gets the size of a diagonal block. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <returns> The block size. </returns>
+		size_t GetBlockSize(const size_t index) const _NOEXCEPT {
+			return static_cast<size_t>(value_->diagonal[index].rows());
+		}
+
+		/// <summary> Gets the offset of a diagonal block, also of its rows and columns. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block, the number of blocks for the border. </param>
+		/// <returns> The offset. </returns>
+		size_t GetBlockOffset(const size_t index) const _NOEXCEPT {
+			return value_->offsets[index];
+		}
+
+		/// <summary> Gets number of the bordering rows and columns. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The border size. </returns>
+		size_t GetBorderSize() const _NOEXCEPT {
+			return static_cast<size_t>(value_->corner.rows());
+		}
+
+		/// <summary> Gets number rows. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The number rows. </returns>
+		size_t GetNumRows() const _NOEXCEPT {
+			return value_->offsets.back() + GetBorderSize();
+		}
+
+		/// <summary> Gets number columns. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The number columns. </returns>
+		size_t GetNumColumns() const _NOEXCEPT {
+			return GetNumRows();
+		}
+
+		/// <summary> Gets a diagonal block D_i. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <returns> The block. </returns>
+		Matrix<_T> GetBlock(const size_t index) const {
+			return Matrix<_T>(value_->diagonal[index]);
+		}
+
+		/// <summary> Sets a diagonal block D_i. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <param name="block"> The block, MUST have the block size. </param>
+		template<int _Layout>
+		void SetBlock(const size_t index, const Matrix<_T, _Layout>& block) {
+			value_.Mutable().diagonal[index] = block.unwrap();
+		}
+
+		/// <summary> Gets the bordering columns B_i of a block. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <returns> The block size by border size columns. </returns>
+		Matrix<_T> GetBorderColumns(const size_t index) const {
+			return Matrix<_T>(value_->border_columns[index]);
+		}
+
+		/// <summary> Sets the bordering columns B_i of a block. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index">   Zero-based index of the block. </param>
+		/// <param name="columns"> The columns, MUST be block size by border size. </param>
+		template<int _Layout>
+		void SetBorderColumns(const size_t index, const Matrix<_T, _Layout>& columns) {
+			value_.Mutable().border_columns[index] = columns.unwrap();
+		}
+
+		/// <summary> Gets the bordering rows C_i of a block. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <returns> The border size by block size rows. </returns>
+		Matrix<_T> GetBorderRows(const size_t index) const {
+			return Matrix<_T>(value_->border_rows[index]);
+		}
+
+		/// <summary> Sets the bordering rows C_i of a block. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the block. </param>
+		/// <param name="rows">  The rows, MUST be border size by block size. </param>
+		template<int _Layout>
+		void SetBorderRows(const size_t index, const Matrix<_T, _Layout>& rows) {
+			value_.Mutable().border_rows[index] = rows.unwrap();
+		}
+
+		/// <summary> Gets the corner G shared by the borders. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The border size square corner. </returns>
+		Matrix<_T> GetCorner() const {
+			return Matrix<_T>(value_->corner);
+		}
+
+		/// <summary> Sets the corner G shared by the borders. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="corner"> The corner, MUST be border size square. </param>
+		template<int _Layout>
+		void SetCorner(const Matrix<_T, _Layout>& corner) {
+			value_.Mutable().corner = corner.unwrap();
+		}
+
+		/// <summary> Get particular item by index, zero outside the blocks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="row_index"> Zero-based index of the row. </param>
+		/// <param name="col_index"> Zero-based index of the col. </param>
+		_T GetElement(size_t row_index, size_t col_index) const _NOEXCEPT {
+			const dense_type* block = Locate(*value_, row_index, col_index);
+			return block ? (*block)(row_index, col_index) : _T(0);
+		}
+
+		/// <summary> Sets an element inside the blocks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="row_index"> The row index. </param>
+		/// <param name="col_index"> The col index. </param>
+		/// <param name="value">	 The value. </param>
+		/// <returns> False if the element is outside the blocks, nothing is changed. </returns>
+		bool SetElement(size_t row_index, size_t col_index, const _T value) {
+			size_t row = row_index, col = col_index;
+			if (!Locate(*value_, row, col))
+				return false;
+			// Located again in the detached blocks
+			_blocks& blocks = value_.Mutable();
+			const_cast<dense_type*>(Locate(blocks, row_index, col_index))->operator()(row_index, col_index) = value;
+			return true;
+		}
+
+		/// <summary> Gets the dense matrix, for small systems and checks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The dense Matrix. </returns>
+		Matrix<_T> ToMatrix() const {
+			return Matrix<_T>(Assemble(*value_));
+		}
+
+	public:
+		/// <summary> Multiply by a vector, block by block in parallel. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="x"> The vector, MUST have the number of columns. </param>
+		/// <returns> The product. </returns>
+		Vector<_T> operator*(const Vector<_T>& x) const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Multiply");
+			typename Vector<_T>::base_type y;
+			MultiplyInto(*value_, x.unwrap(), y);
+			return Vector<_T>(std::move(y));
+		}
+
+		/// <summary> Multiply by a matrix, block by block in parallel. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="x"> The matrix, MUST have the number of columns as rows. </param>
+		/// <returns> The product. </returns>
+		template<int _Layout>
+		Matrix<_T, _Layout> operator*(const Matrix<_T, _Layout>& x) const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Multiply");
+			typename Matrix<_T, _Layout>::base_type y;
+			MultiplyInto(*value_, x.unwrap(), y);
+			return Matrix<_T, _Layout>(std::move(y));
+		}
+
+		/// <summary> Solve <c>A x = b</c> with the cached factorization. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand side, MUST have the number of rows. </param>
+		/// <returns> The solution, empty if this is singular. </returns>
+		Vector<_T> Solve(const Vector<_T>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Solve");
+			const factorization_ptr factorization = Factorize();
+			if (!factorization->invertible)
+				return Vector<_T>();
+			typename Vector<_T>::base_type x;
+			if (factorization->blocked)
+				SolveInto(*value_, *factorization, b.unwrap(), x);
+			else
+				x = factorization->dense.solve(b.unwrap());
+			return Vector<_T>(std::move(x));
+		}
+
+		/// <summary> Solve <c>A X = B</c> for several right-hand sides with the cached factorization. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand sides, MUST have the number of rows. </param>
+		/// <returns> The solutions, empty if this is singular. </returns>
+		template<int _Layout>
+		Matrix<_T, _Layout> Solve(const Matrix<_T, _Layout>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Solve");
+			const factorization_ptr factorization = Factorize();
+			if (!factorization->invertible)
+				return Matrix<_T, _Layout>();
+			typename Matrix<_T, _Layout>::base_type x;
+			if (factorization->blocked)
+				SolveInto(*value_, *factorization, b.unwrap(), x);
+			else
+				x = factorization->dense.solve(b.unwrap());
+			return Matrix<_T, _Layout>(std::move(x));
+		}
+
+		/// <summary>
+		/// 	<para> Gets the inverse, a cached inverse is returned in O(1). </para>
+		/// 	<para> The inverse is dense unless there is no border, prefer <c>Solve</c>. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> A Matrix&lt;_T&gt;, empty if this is singular </returns>
+		Matrix<_T> Inv() const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Inv");
+			Matrix<_T> lazy_value;
+			const bool cached = value_.FindLazyValue("inverse_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("inverse_value", cached);
+			if (!cached) {
+				const size_t size = GetNumRows();
+				lazy_value = Solve(Matrix<_T>(dense_type(dense_type::Identity(size, size))));
+				if (lazy_value.GetNumRows() != size)
+					return Matrix<_T>();
+				value_.StoreLazyValue("inverse_value", lazy_value);
+			}
+			return lazy_value;
+		}
+
+		/// <summary> Get matrix determinant value, the product of the block and Schur complement determinants. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> Determinant value </returns>
+		_T DetGauss() const {
+			NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::DetGauss");
+			const factorization_ptr factorization = Factorize();
+			if (!factorization->invertible)
+				return _T(0);
+			if (!factorization->blocked)
+				return factorization->dense.determinant();
+			_T determinant = _T(1);
+			for (size_t i = 0; i < factorization->blocks.size(); i++)
+				determinant *= factorization->blocks[i].determinant();
+			if (value_->corner.rows() > 0)
+				determinant *= factorization->schur.determinant();
+			return determinant;
+		}
+
+	private:
+		// The blocks, shared by copies together with the cached factorization
+		struct _blocks {
+			std::vector<size_t> offsets;				// Offsets of the blocks, the border offset at the end
+			std::vector<dense_type> diagonal;			// D_i
+			std::vector<dense_type> border_columns;		// B_i, block size by border size
+			std::vector<dense_type> border_rows;		// C_i, border size by block size
+			dense_type corner;							// G
+
+			_blocks() : offsets(1, 0) {}
+		};
+
+		// Factorization of the blocks and of the Schur complement, or of the dense matrix if a block is singular
+		struct _factorization {
+			std::vector<Eigen::FullPivLU<dense_type>> blocks;
+			std::vector<dense_type> solved_borders;		// D_i^-1 B_i
+			Eigen::FullPivLU<dense_type> schur;
+			Eigen::FullPivLU<dense_type> dense;
+			bool blocked;
+			bool invertible;
+		};
+
+		// Work (multiply-adds) worth a worker thread, smaller loops over the blocks run serially
+		enum { parallel_work = 1 << 16 };
+
+		typedef std::shared_ptr<const _factorization> factorization_ptr;
+
+		static dense_type Assemble(const _blocks& blocks) {
+			const Eigen::Index local = blocks.offsets.back(), border = blocks.corner.rows();
+			dense_type dense = dense_type::Zero(local + border, local + border);
+			for (size_t i = 0; i < blocks.diagonal.size(); i++) {
+				const Eigen::Index offset = blocks.offsets[i], size = blocks.diagonal[i].rows();
+				dense.block(offset, offset, size, size) = blocks.diagonal[i];
+				dense.block(offset, local, size, border) = blocks.border_columns[i];
+				dense.block(local, offset, border, size) = blocks.border_rows[i];
+			}
+			dense.bottomRightCorner(border, border) = blocks.corner;
+			return dense;
+		}
+
+		/// <summary> Number of worker threads of a loop over the blocks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="blocks">  The blocks. </param>
+		/// <param name="columns"> Columns of the right-hand side, or 0 to factorize. </param>
+		static size_t Workers(const _blocks& blocks, const Eigen::Index columns) _NOEXCEPT {
+			const Eigen::Index border = blocks.corner.rows();
+			size_t work = 0;
+			for (size_t i = 0; i < blocks.diagonal.size(); i++) {
+				const Eigen::Index size = blocks.diagonal[i].rows();
+				work += static_cast<size_t>(size * (size + border) * (columns > 0 ? columns : size));
+			}
+			return std::max<size_t>(std::min(GetParallelism(), work / parallel_work), 1);
+		}
+
+		static _blocks MakeBlocks(const std::vector<size_t>& block_sizes, const size_t border_size) {
+			const Eigen::Index border = static_cast<Eigen::Index>(border_size);
+			_blocks blocks;
+			for (size_t i = 0; i < block_sizes.size(); i++) {
+				const Eigen::Index size = static_cast<Eigen::Index>(block_sizes[i]);
+				blocks.offsets.push_back(blocks.offsets.back() + block_sizes[i]);
+				blocks.diagonal.push_back(dense_type::Zero(size, size));
+				blocks.border_columns.push_back(dense_type::Zero(size, border));
+				blocks.border_rows.push_back(dense_type::Zero(border, size));
+			}
+			blocks.corner = dense_type::Zero(border, border);
+			return blocks;
+		}
+
+		/// <summary> Locate an element in the blocks. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="blocks">    The blocks. </param>
+		/// <param name="row_index"> [in,out] The row index, the index in the block on return. </param>
+		/// <param name="col_index"> [in,out] The col index, the index in the block on return. </param>
+		/// <returns> The block, null if the element is outside the blocks. </returns>
+		static const dense_type* Locate(const _blocks& blocks, size_t& row_index, size_t& col_index) _NOEXCEPT {
+			const size_t count = blocks.diagonal.size();
+			const size_t row_block = FindBlock(blocks, row_index), col_block = FindBlock(blocks, col_index);
+			row_index -= blocks.offsets[row_block];
+			col_index -= blocks.offsets[col_block];
+			if (row_block == count)
+				return col_block == count ? &blocks.corner : &blocks.border_rows[col_block];
+			if (col_block == count)
+				return &blocks.border_columns[row_block];
+			return row_block == col_block ? &blocks.diagonal[row_block] : nullptr;
+		}
+
+		// Index of the block of a row or column, the number of blocks for the border
+		static size_t FindBlock(const _blocks& blocks, const size_t index) _NOEXCEPT {
+			if (index >= blocks.offsets.back())
+				return blocks.diagonal.size();
+			return std::upper_bound(blocks.offsets.begin(), blocks.offsets.end(), index) - blocks.offsets.begin() - 1;
+		}
+
+		/// <summary> Gets the factorization, a cached one is returned in O(1). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The factorization. </returns>
+		factorization_ptr Factorize() const {
+			factorization_ptr lazy_value;
+			const bool cached = value_.FindLazyValue("factorization_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("factorization_value", cached);
+			if (!cached) {
+				NUDTTK_INSTRUMENT_SCOPE("BlockDiagonalMatrix::Factorize");
+				lazy_value = MakeFactorization(*value_);
+				value_.StoreLazyValue("factorization_value", lazy_value);
+			}
+			return lazy_value;
+		}
+
+		static factorization_ptr MakeFactorization(const _blocks& blocks) {
+			const size_t count = blocks.diagonal.size();
+			const Eigen::Index border = blocks.corner.rows();
+			std::shared_ptr<_factorization> factorization = std::make_shared<_factorization>();
+			factorization->blocks.resize(count);
+			factorization->solved_borders.resize(count);
+			// Blocks are independent, their Schur complement updates C_i D_i^-1 B_i are summed afterwards
+			std::vector<dense_type> updates(count);
+			ParallelFor(0, count, [&](const size_t i) {
+				factorization->blocks[i].compute(blocks.diagonal[i]);
+				if (border > 0 && factorization->blocks[i].isInvertible()) {
+					factorization->solved_borders[i] = factorization->blocks[i].solve(blocks.border_columns[i]);
+					updates[i].noalias() = blocks.border_rows[i].operator*(factorization->solved_borders[i]);
+				}
+			}, Workers(blocks, 0));
+			factorization->blocked = true;
+			for (size_t i = 0; i < count; i++)
+				factorization->blocked = factorization->blocked && factorization->blocks[i].isInvertible();
+			if (!factorization->blocked) {
+				// The border may still make the whole matrix invertible, e.g. a parameter only observed
+				// through the global ones
+				factorization->dense.compute(Assemble(blocks));
+				factorization->invertible = factorization->dense.isInvertible();
+				return factorization;
+			}
+			// det A = prod det D_i * det S, a singular Schur complement means a singular matrix
+			factorization->invertible = true;
+			if (border > 0) {
+				dense_type schur = blocks.corner;
+				for (size_t i = 0; i < count; i++)
+					schur -= updates[i];
+				factorization->schur.compute(schur);
+				factorization->invertible = factorization->schur.isInvertible();
+			}
+			return factorization;
+		}
+
+		/// <summary> Evaluate <c>y = A x</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="blocks"> The blocks. </param>
+		/// <param name="x">	  The vector or matrix. </param>
+		/// <param name="y">	  [out] The product. </param>
+		template<typename _Dense>
+		static void MultiplyInto(const _blocks& blocks, const _Dense& x, _Dense& y) {
+			const Eigen::Index border = blocks.corner.rows();
+			y.resize(x.rows(), x.cols());
+			ParallelFor(0, blocks.diagonal.size(), [&](const size_t i) {
+				const Eigen::Index offset = blocks.offsets[i], size = blocks.diagonal[i].rows();
+				y.middleRows(offset, size).noalias() = blocks.diagonal[i].operator*(x.middleRows(offset, size));
+				if (border > 0)
+					y.middleRows(offset, size).noalias() += blocks.border_columns[i].operator*(x.bottomRows(border));
+			}, Workers(blocks, x.cols()));
+			if (border > 0) {
+				y.bottomRows(border).noalias() = blocks.corner.operator*(x.bottomRows(border));
+				for (size_t i = 0; i < blocks.diagonal.size(); i++)
+					y.bottomRows(border).noalias() += blocks.border_rows[i].operator*(x.middleRows(blocks.offsets[i], blocks.diagonal[i].rows()));
+			}
+		}
+
+		/// <summary> Solve <c>A x = b</c> by block elimination. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="blocks">		 The blocks. </param>
+		/// <param name="factorization"> The factorization of the blocks, MUST be invertible. </param>
+		/// <param name="b">			 The right-hand side. </param>
+		/// <param name="x">			 [out] The solution. </param>
+		template<typename _Dense>
+		static void SolveInto(const _blocks& blocks, const _factorization& factorization, const _Dense& b, _Dense& x) {
+			const Eigen::Index border = blocks.corner.rows();
+			const size_t count = blocks.diagonal.size(), workers = Workers(blocks, b.cols());
+			x.resize(b.rows(), b.cols());
+			// y_i = D_i^-1 b_i
+			ParallelFor(0, count, [&](const size_t i) {
+				const Eigen::Index offset = blocks.offsets[i], size = blocks.diagonal[i].rows();
+				x.middleRows(offset, size) = factorization.blocks[i].solve(b.middleRows(offset, size));
+			}, workers);
+			if (border == 0)
+				return;
+			// x_g = S^-1 (b_g - sum C_i y_i), then x_i = y_i - D_i^-1 B_i x_g
+			_Dense reduced = b.bottomRows(border);
+			for (size_t i = 0; i < count; i++)
+				reduced.noalias() -= blocks.border_rows[i].operator*(x.middleRows(blocks.offsets[i], blocks.diagonal[i].rows()));
+			x.bottomRows(border) = factorization.schur.solve(reduced);
+			ParallelFor(0, count, [&](const size_t i) {
+				const Eigen::Index offset = blocks.offsets[i], size = blocks.diagonal[i].rows();
+				x.middleRows(offset, size).noalias() -= factorization.solved_borders[i].operator*(x.bottomRows(border));
+			}, workers);
+		}
+
+		// The blocks, shared by copies together with the cached factorization and inverse
+		_shared_storage<_blocks> value_;
+	};
+}
+
+#endif	// !_NUDTTK_MATH_BLOCK_DIAGONAL_MATRIX_TR_
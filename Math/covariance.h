@@ -0,0 +1,173 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_COVARIANCE_TR_
+#define _NUDTTK_MATH_COVARIANCE_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> Covariance propagation <c>F P F^T + Q</c> of filters, fused into one routine that
+	/// 	writes a preallocated destination, e.g. the predicted covariance, or <c>H P H^T + R</c> of the
+	/// 	innovation with a design matrix H of m x n. </para>
+	/// 	<para> P and Q are symmetric, only their lower triangles are read. <c>G = F P</c> is the
+	/// 	product with P of its lower triangle, only the lower triangle of <c>G F^T + Q</c> is
+	/// 	computed and mirrored, so the result is exactly symmetric and no transpose is materialized.
+	/// 	Small systems keep G on the stack and take the triangle by dot products of rows, large ones by
+	/// 	the triangular GEMM. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T = double>
+	class Covariance {
+	public:
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> row_major_type;
+
+	public:
+		/// <summary> Propagate <c>out = F P F^T + Q</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out"> [out] The destination, resized to m x m if needed, MAY be p or q but MUST NOT be f. </param>
+		/// <param name="f">   The transition (design) matrix F of m x n. </param>
+		/// <param name="p">   The symmetric covariance P of n x n, only the lower triangle is read. </param>
+		/// <param name="q">   The symmetric noise Q of m x m, only the lower triangle is read. </param>
+		/// <returns> False if the sizes do not match. </returns>
+		template<int _Layout, int _LayoutF, int _LayoutP, int _LayoutQ>
+		static bool Propagate(Matrix<_T, _Layout>& out, const Matrix<_T, _LayoutF>& f,
+							  const Matrix<_T, _LayoutP>& p, const Matrix<_T, _LayoutQ>& q) {
+			NUDTTK_INSTRUMENT_SCOPE("Covariance::Propagate");
+			const typename Matrix<_T, _LayoutF>::base_type& f_value = *f.value_;
+			const typename Matrix<_T, _LayoutP>::base_type& p_value = *p.value_;
+			const typename Matrix<_T, _LayoutQ>::base_type& q_value = *q.value_;
+			const Eigen::Index m = f_value.rows(), n = f_value.cols();
+			if (p_value.rows() != n || p_value.cols() != n || q_value.rows() != m || q_value.cols() != m)
+				return false;
+			if (m <= small_size && n <= small_size) {
+				small_type g(m, n);
+				SmallProduct(f_value, p_value, g);
+				// G holds all that is read of p, a destination sharing it is written from here on
+				typename Matrix<_T, _Layout>::base_type& value = Overwritable(out, m);
+				AddTriangle(value, g, f_value, q_value);
+			} else {
+				row_major_type g(m, n);
+				g.transpose().noalias() = p_value.template selfadjointView<Eigen::Lower>().operator*(f_value.transpose());
+				typename Matrix<_T, _Layout>::base_type& value = Overwritable(out, m);
+				AddTriangle(value, g, f_value, q_value);
+			}
+			return true;
+		}
+
+		/// <summary> Propagate <c>out = F P F^T + Q</c> on arrays, see above. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="f">   F of m x n row by row. </param>
+		/// <param name="p">   P of n x n row by row. </param>
+		/// <param name="q">   Q of m x m row by row. </param>
+		/// <param name="m">   The rows of F. </param>
+		/// <param name="n">   The columns of F. </param>
+		/// <param name="out"> [out] The m x m result row by row, MAY be p or q but MUST NOT be f. </param>
+		static void Propagate(const _T f[], const _T p[], const _T q[], const size_t m, const size_t n, _T out[]) {
+			NUDTTK_INSTRUMENT_SCOPE("Covariance::Propagate");
+			PropagateArrays(f, p, q, static_cast<Eigen::Index>(m), static_cast<Eigen::Index>(n), out);
+		}
+
+		/// <summary>
+		/// 	<para> Propagate the covariances of many objects, <c>out_k = F_k P_k F_k^T + Q_k</c>. </para>
+		/// 	<para> Objects are split into contiguous chunks over worker threads. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="f">	 F of every object one after another, each m x n row by row. </param>
+		/// <param name="p">	 P of every object, each n x n. </param>
+		/// <param name="q">	 Q of every object, each m x m. </param>
+		/// <param name="m">	 The rows of F. </param>
+		/// <param name="n">	 The columns of F. </param>
+		/// <param name="count"> Number of the objects. </param>
+		/// <param name="out">	 [out] The results one after another, each m x m, MAY be p or q but MUST NOT be f. </param>
+		static void Propagate(const _T f[], const _T p[], const _T q[], const size_t m, const size_t n,
+							  const size_t count, _T out[]) {
+			NUDTTK_INSTRUMENT_SCOPE("Covariance::PropagateBatch");
+			const size_t chunks = std::max<size_t>(std::min(GetParallelism(), count * m * m * n / batch_work), 1);
+#if __cplusplus >= 201103L
+			ParallelFor(0, chunks, [&](const size_t chunk) {
+				for (size_t k = chunk * count / chunks; k < (chunk + 1) * count / chunks; k++)
+					PropagateArrays(f + k * m * n, p + k * n * n, q + k * m * m,
+									static_cast<Eigen::Index>(m), static_cast<Eigen::Index>(n), out + k * m * m);
+			}, chunks);
+#else	// __cplusplus < 201103L
+			for (size_t k = 0; k < count; k++)
+				PropagateArrays(f + k * m * n, p + k * n * n, q + k * m * m,
+								static_cast<Eigen::Index>(m), static_cast<Eigen::Index>(n), out + k * m * m);
+#endif	// __cplusplus >= 201103L
+		}
+
+	private:
+		// Largest sizes of G on the stack and of P expanded for the coefficient-based product, and the
+		// work (multiply-adds) worth a worker thread in a batch
+		enum { small_size = 16, lazy_size = 8, batch_work = 1 << 16 };
+
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor, small_size, small_size> small_type;
+
+		static void PropagateArrays(const _T f[], const _T p[], const _T q[], const Eigen::Index m, const Eigen::Index n, _T out[]) {
+			typedef Eigen::Map<const row_major_type> map_type;
+			const map_type f_value(f, m, n), p_value(p, n, n), q_value(q, m, m);
+			Eigen::Map<row_major_type> value(out, m, m);
+			if (m <= small_size && n <= small_size) {
+				small_type g(m, n);
+				SmallProduct(f_value, p_value, g);
+				AddTriangle(value, g, f_value, q_value);
+			} else {
+				row_major_type g(m, n);
+				g.transpose().noalias() = p_value.template selfadjointView<Eigen::Lower>().operator*(f_value.transpose());
+				AddTriangle(value, g, f_value, q_value);
+			}
+		}
+
+		/// <summary> Evaluate <c>G = F P</c> of small sizes on the stack, P expanded from its lower triangle. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		template<typename _F, typename _P>
+		static void SmallProduct(const _F& f, const _P& p, small_type& g) {
+			// The coefficient-based product of Eigen skips the packing of the symmetric GEMM, which
+			// pays off only for the smallest sizes
+			if (p.rows() <= lazy_size) {
+				small_type full(p.rows(), p.cols());
+				full = p.template selfadjointView<Eigen::Lower>();
+				g.noalias() = f.lazyProduct(full);
+			} else {
+				g.transpose().noalias() = p.template selfadjointView<Eigen::Lower>().operator*(f.transpose());
+			}
+		}
+
+		template<int _Layout>
+		static typename Matrix<_T, _Layout>::base_type& Overwritable(Matrix<_T, _Layout>& out, const Eigen::Index m) {
+			typename Matrix<_T, _Layout>::base_type& value = out.value_.Overwrite();
+			if (value.rows() != m || value.cols() != m)
+				value.resize(m, m);
+			return value;
+		}
+
+		/// <summary> Evaluate the lower triangle of <c>out = G F^T + Q</c> and mirror it. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		template<typename _Out, typename _G, typename _F, typename _Q>
+		static void AddTriangle(_Out& out, const _G& g, const _F& f, const _Q& q) {
+			const Eigen::Index m = out.rows();
+			if (m <= small_size) {
+				// Elements are written in place of those of q read for them, so out may be q
+				for (Eigen::Index i = 0; i < m; i++) {
+					for (Eigen::Index j = 0; j <= i; j++)
+						out(i, j) = g.row(i).dot(f.row(j)) + q(i, j);
+				}
+			} else {
+				// The triangular GEMM accumulates onto the triangle of q, a no-op copy when out is q
+				out.template triangularView<Eigen::Lower>() = q;
+				out.template triangularView<Eigen::Lower>() += g.operator*(f.transpose());
+			}
+			out.template triangularView<Eigen::StrictlyUpper>() = out.transpose();
+		}
+	};
+}
+
+#endif	// !_NUDTTK_MATH_COVARIANCE_TR_
@@ -0,0 +1,317 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_DEFERRED_TR_
+#define _NUDTTK_MATH_DEFERRED_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "elementwise.h"
+#include "parallel.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+
+#if __cplusplus < 201103L
+#error You need to compile deferred evaluation with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	/// <summary> Inversion of an evaluated value. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct _inverse {
+		/// <summary> Inverse of a matrix, cached for the matrix. </summary>
+		template<typename _T, int _Layout>
+		static _Result apply(const Matrix<_T, _Layout>& operand) {
+			return _Result(operand.Inv().unwrap());
+		}
+
+		/// <summary> Inverse of an expression. </summary>
+		template<typename _Operand>
+		static _Result apply(const _Operand& operand) {
+			return Invert(operand.template unwrap<_Result>());
+		}
+
+		/// <summary> Inverse of a value, empty if it is singular. </summary>
+		template<typename _Value>
+		static _Result Invert(const _Value& value) {
+			const Eigen::FullPivLU<_Result> lu(value);
+			return lu.isInvertible() ? _Result(lu.inverse()) : _Result();
+		}
+	};
+
+	/// <summary>
+	/// 	<para> Inverse as an expression node, see <c>Inverse</c>. </para>
+	/// 	<para> The second parameter only lets the node combine with the operators of the binary nodes. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand"> Type of the operand. </typeparam>
+	template<typename _Operand, typename _Unused = void>
+	class inv_op_impl {
+	public:
+		_CONSTEXPR_FN inv_op_impl(const _Operand& operand) _NOEXCEPT
+			: operand_(operand) {}
+
+		_CONSTEXPR_FN const _Operand& operand() const _NOEXCEPT {
+			return operand_;
+		}
+
+		template<typename _Result>
+		_Result unwrap() const {
+			return _inverse<_Result>::apply(operand_);
+		}
+
+	private:
+		typename _operand_holder<_Operand>::type operand_;
+	};
+
+	/// <summary>
+	/// 	<para> Inverse of a matrix or an expression as an expression node, e.g.
+	/// 	<c>A * B + Inverse(E)</c>, which <c>EvaluateDeferred</c> schedules like a product. </para>
+	/// 	<para> Evaluated eagerly it is the same as <c>Inv()</c>, empty if the operand is singular. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="operand"> The operand. </param>
+	/// <returns> The inverse node. </returns>
+	template<typename _Operand>
+	_CONSTEXPR_FN inv_op_impl<_Operand> Inverse(const _Operand& operand) _NOEXCEPT {
+		return inv_op_impl<_Operand>(operand);
+	}
+
+	/// <summary>
+	/// 	<para> The graph of a deferred evaluation. </para>
+	/// 	<para> Products of matrices and inverses are registered as tasks in post order, keyed by
+	/// 	their structure and the storage of the matrices, so an identical subexpression is one task.
+	/// 	Sums, differences and scalings are evaluated by the tasks using them, or at last. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the evaluated values. </typeparam>
+	template<typename _Result>
+	class _deferred_graph {
+	public:
+		typedef typename _Result::Scalar scalar_type;
+
+		/// <summary> Register the products and inverses of an expression, children first. </summary>
+		template<typename _Leaf>
+		void Schedule(const _Leaf&) {}
+
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		void Schedule(const _Impl<_Lhs, _Rhs>& node) {
+			Schedule(node.lhs());
+			Schedule(node.rhs());
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		void Schedule(const mul_op_impl<_Lhs, _Rhs>& node) {
+			Schedule(node.lhs());
+			Schedule(node.rhs());
+			Register(node);
+		}
+
+		template<typename _Lhs, typename _Scalar>
+		void Schedule(const mul_op_impl<_Lhs, _scalar_support<_Scalar>>& node) {
+			Schedule(node.lhs());
+		}
+
+		template<typename _Scalar, typename _Rhs>
+		void Schedule(const mul_op_impl<_scalar_support<_Scalar>, _Rhs>& node) {
+			Schedule(node.rhs());
+		}
+
+		template<typename _Operand, typename _Unused>
+		void Schedule(const inv_op_impl<_Operand, _Unused>& node) {
+			Schedule(node.operand());
+			Register(node);
+		}
+
+		template<typename _Operand, typename _Function>
+		void Schedule(const unary_op_impl<_Operand, _Function>& node) {
+			Schedule(node.operand());
+		}
+
+		/// <summary> Run the tasks, a task waits for the tasks registered before it that it uses. </summary>
+		/// <returns> Number of the tasks. </returns>
+		size_t Run() {
+			ParallelFor(0, tasks_.size(), [this](const size_t i) { tasks_[i](); });
+			return tasks_.size();
+		}
+
+		/// <summary> Evaluate an expression, the results of registered nodes are taken from their tasks. </summary>
+		template<typename _Leaf>
+		auto Eval(const _Leaf& leaf) const -> decltype(leaf.template unwrap<_Result>()) {
+			return leaf.template unwrap<_Result>();
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Eval(const add_op_impl<_Lhs, _Rhs>& node) const {
+			return add_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Eval(const sub_op_impl<_Lhs, _Rhs>& node) const {
+			return sub_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Eval(const div_op_impl<_Lhs, _Rhs>& node) const {
+			return div_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		const _Result& Eval(const mul_op_impl<_Lhs, _Rhs>& node) const {
+			return futures_.find(Key(node))->second.get();
+		}
+
+		template<typename _Lhs, typename _Scalar>
+		_Result Eval(const mul_op_impl<_Lhs, _scalar_support<_Scalar>>& node) const {
+			return mul_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Scalar, typename _Rhs>
+		_Result Eval(const mul_op_impl<_scalar_support<_Scalar>, _Rhs>& node) const {
+			return mul_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Operand, typename _Unused>
+		const _Result& Eval(const inv_op_impl<_Operand, _Unused>& node) const {
+			return futures_.find(Key(node))->second.get();
+		}
+
+		template<typename _Operand, typename _Function>
+		_Result Eval(const unary_op_impl<_Operand, _Function>& node) const {
+			return node.template apply<_Result>(Eval(node.operand()));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Eval(const cwise_mul_op_impl<_Lhs, _Rhs>& node) const {
+			return cwise_mul_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Eval(const cwise_div_op_impl<_Lhs, _Rhs>& node) const {
+			return cwise_div_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+	private:
+		template<typename _Node>
+		void Register(const _Node& node) {
+			const std::string key = Key(node);
+			if (futures_.count(key))
+				return;
+			// The node outlives the tasks, which are run before the evaluation returns
+			std::packaged_task<_Result()> task([this, &node]() { return Compute(node); });
+			futures_[key] = task.get_future().share();
+			tasks_.push_back(std::move(task));
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		_Result Compute(const mul_op_impl<_Lhs, _Rhs>& node) const {
+			return mul_op_impl_evaluate<_Result>::apply(Eval(node.lhs()), Eval(node.rhs()));
+		}
+
+		template<typename _T, int _Layout, typename _Unused>
+		_Result Compute(const inv_op_impl<Matrix<_T, _Layout>, _Unused>& node) const {
+			return _inverse<_Result>::apply(node.operand());
+		}
+
+		template<typename _Operand, typename _Unused>
+		_Result Compute(const inv_op_impl<_Operand, _Unused>& node) const {
+			return _inverse<_Result>::Invert(Eval(node.operand()));
+		}
+
+		/// <summary>
+		/// 	<para> Key of an expression, the storage identifies a matrix, so copies are the same. </para>
+		/// 	<para> Other nodes, e.g. element-wise functions, are identified by their address. </para>
+		/// </summary>
+		template<typename _Leaf>
+		static std::string Key(const _Leaf& leaf) {
+			std::ostringstream key;
+			key << "@" << static_cast<const void*>(&leaf);
+			return key.str();
+		}
+
+		template<typename _T, int _Layout>
+		static std::string Key(const Matrix<_T, _Layout>& leaf) {
+			std::ostringstream key;
+			key << "M" << _Layout << "@" << static_cast<const void*>(leaf.unwrap().data());
+			return key.str();
+		}
+
+		template<typename _Scalar>
+		static std::string Key(const _scalar_support<_Scalar>& leaf) {
+			std::ostringstream key;
+			key << std::setprecision(17) << leaf.template unwrap<_Result>();
+			return key.str();
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const add_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + "+" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const sub_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + "-" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const mul_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + "*" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const div_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + "/" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const cwise_mul_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + ".*" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Lhs, typename _Rhs>
+		static std::string Key(const cwise_div_op_impl<_Lhs, _Rhs>& node) {
+			return "(" + Key(node.lhs()) + "./" + Key(node.rhs()) + ")";
+		}
+
+		template<typename _Operand, typename _Unused>
+		static std::string Key(const inv_op_impl<_Operand, _Unused>& node) {
+			return "inv(" + Key(node.operand()) + ")";
+		}
+
+		// Results of the registered nodes by key
+		std::map<std::string, std::shared_future<_Result>> futures_;
+		// Tasks of the registered nodes in post order
+		std::vector<std::packaged_task<_Result()>> tasks_;
+	};
+
+	/// <summary>
+	/// 	<para> Evaluate an expression into the destination with independent products and inverses
+	/// 	running concurrently, e.g. <c>EvaluateDeferred(out, A * B + C * D - Inverse(E))</c>. </para>
+	/// 	<para> The expression tree is recorded as a DAG first, identical subexpressions such as two
+	/// 	<c>A * B</c> are evaluated once, then the products and inverses are run on worker threads,
+	/// 	children before parents. The remaining sums and scalings are evaluated last. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="destination"> [out] The destination, may be used in the expression. </param>
+	/// <param name="expression">  The expression. </param>
+	/// <returns> Number of the distinct products and inverses evaluated. </returns>
+	template<typename _T, int _Layout, typename _Expression>
+	size_t EvaluateDeferred(Matrix<_T, _Layout>& destination, const _Expression& expression) {
+		NUDTTK_INSTRUMENT_SCOPE("Matrix::EvaluateDeferred");
+		typedef typename Matrix<_T, _Layout>::base_type result_type;
+		_deferred_graph<result_type> graph;
+		graph.Schedule(expression);
+		const size_t tasks = graph.Run();
+		destination = Matrix<_T, _Layout>(result_type(graph.Eval(expression)));
+		return tasks;
+	}
+}
+
+#endif	// !_NUDTTK_MATH_DEFERRED_TR_
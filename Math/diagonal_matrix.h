@@ -0,0 +1,283 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_DIAGONAL_MATRIX_TR_
+#define _NUDTTK_MATH_DIAGONAL_MATRIX_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+
+namespace NUDTTK {
+
+	template<typename _T = double>
+	class DiagonalMatrix;
+
+	/// <summary> Diagonal-matrix product, evaluated by scaling the rows. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, int _Layout>
+	_CONSTEXPR_FN mul_op_impl<DiagonalMatrix<_T>, Matrix<_T, _Layout>>
+		operator*(const DiagonalMatrix<_T>& lhs, const Matrix<_T, _Layout>& rhs) {
+		return mul_op_impl<DiagonalMatrix<_T>, Matrix<_T, _Layout>>(lhs, rhs);
+	}
+
+	/// <summary> Matrix-diagonal product, evaluated by scaling the columns. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, int _Layout>
+	_CONSTEXPR_FN mul_op_impl<Matrix<_T, _Layout>, DiagonalMatrix<_T>>
+		operator*(const Matrix<_T, _Layout>& lhs, const DiagonalMatrix<_T>& rhs) {
+		return mul_op_impl<Matrix<_T, _Layout>, DiagonalMatrix<_T>>(lhs, rhs);
+	}
+
+	/// <summary> Diagonal-vector product, evaluated elementwise. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, int _Size>
+	_CONSTEXPR_FN mul_op_impl<DiagonalMatrix<_T>, Vector<_T, _Size>>
+		operator*(const DiagonalMatrix<_T>& lhs, const Vector<_T, _Size>& rhs) {
+		return mul_op_impl<DiagonalMatrix<_T>, Vector<_T, _Size>>(lhs, rhs);
+	}
+
+	/// <summary> Diagonal-expression product. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN mul_op_impl<DiagonalMatrix<_T>, _Impl<_Lhs, _Rhs>>
+		operator*(const DiagonalMatrix<_T>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {
+		return mul_op_impl<DiagonalMatrix<_T>, _Impl<_Lhs, _Rhs>>(lhs, rhs);
+	}
+
+	/// <summary> Expression-diagonal product, e.g. <c>C.Transpose() * W</c>. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN mul_op_impl<_Impl<_Lhs, _Rhs>, DiagonalMatrix<_T>>
+		operator*(const _Impl<_Lhs, _Rhs>& lhs, const DiagonalMatrix<_T>& rhs) {
+		return mul_op_impl<_Impl<_Lhs, _Rhs>, DiagonalMatrix<_T>>(lhs, rhs);
+	}
+
+	/// <summary>
+	/// 	<para> A weighted product <c>X * W * Y</c>, e.g. the normal matrix <c>C^T W C</c> or the
+	/// 	right-hand side <c>C^T W y</c>. </para>
+	/// 	<para> Evaluated by <c>DiagonalMatrix::Multiply</c> in blocks of rows of <c>Y</c>, neither
+	/// 	<c>X * W</c> nor <c>W * Y</c> is stored as a whole. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Lhs"> Type of X. </typeparam>
+	/// <typeparam name="_T">   Type of the weights. </typeparam>
+	/// <typeparam name="_Rhs"> Type of Y. </typeparam>
+	template<typename _Lhs, typename _T, typename _Rhs>
+	class mul_op_impl<mul_op_impl<_Lhs, DiagonalMatrix<_T>>, _Rhs> {
+	public:
+		typedef mul_op_impl<_Lhs, DiagonalMatrix<_T>> lhs_type;
+
+		_CONSTEXPR_FN mul_op_impl(const lhs_type& lhs, const _Rhs& rhs) _NOEXCEPT
+			: lhs_(lhs), rhs_(rhs) {}
+
+		_CONSTEXPR_FN const lhs_type& lhs() const _NOEXCEPT {
+			return lhs_;
+		}
+
+		_CONSTEXPR_FN const _Rhs& rhs() const _NOEXCEPT {
+			return rhs_;
+		}
+
+		template<typename _Result>
+		_Result unwrap() const {
+			return evaluate<_Result>(rhs_);
+		}
+
+	private:
+		template<typename _Result, typename _Operand>
+		_Result evaluate(const _Operand& rhs) const {
+			return DiagonalMatrix<_T>::template Evaluate<_Result>(
+				lhs_.lhs().template unwrap<typename _operand_result<_Lhs, _Result>::type>(), lhs_.rhs(),
+				rhs.template unwrap<typename _operand_result<_Operand, _Result>::type>());
+		}
+
+		// Only scaled, X * W is evaluated by the inner node
+		template<typename _Result, typename _Scalar>
+		_Result evaluate(const _scalar_support<_Scalar>& rhs) const {
+			_Result result = lhs_.template unwrap<_Result>();
+			result *= rhs.template unwrap<_Result>();
+			return result;
+		}
+
+		typename _operand_holder<lhs_type>::type lhs_;
+		typename _operand_holder<_Rhs>::type rhs_;
+	};
+
+	/// <summary>
+	/// 	<para> A diagonal matrix, e.g. the observation weights of a least squares fit. </para>
+	/// 	<para> Only the diagonal is stored. Products with Matrix and Vector scale rows or columns
+	/// 	in one streaming pass, and <c>X * W * Y</c> is evaluated blockwise without a scaled copy of
+	/// 	X or Y, see <c>Multiply</c>. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T>
+	class DiagonalMatrix {
+	public:
+		typedef Eigen::DiagonalMatrix<_T, Eigen::Dynamic> base_type;
+		typedef typename base_type::DiagonalVectorType diagonal_type;
+		CLS_UNWRAP(DiagonalMatrix, base_type, value_);
+
+	public:
+		/// <summary> Default constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN DiagonalMatrix() _NOEXCEPT {}
+
+		/// <summary> Initialize identity DiagonalMatrix in size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size"> The size. </param>
+		explicit DiagonalMatrix(const size_t size) _NOEXCEPT
+			: value_(diagonal_type::Ones(size)) {}
+
+		/// <summary> Initialize DiagonalMatrix in size with a copy of the diagonal. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size">		The size. </param>
+		/// <param name="diagonal"> The diagonal, the caller MUST ensure there are <c>size</c> values. </param>
+		DiagonalMatrix(const size_t size, const _T diagonal[])
+			: value_(diagonal_type(Eigen::Map<const diagonal_type>(diagonal, size))) {}
+
+		/// <summary> Initialize DiagonalMatrix with a copy of the diagonal. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="diagonal"> The diagonal. </param>
+		template<int _Size>
+		explicit DiagonalMatrix(const Vector<_T, _Size>& diagonal)
+			: value_(diagonal_type(diagonal.unwrap())) {}
+
+	public:
+		/// <summary> Gets the size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The size. </returns>
+		_CONSTEXPR_FN size_t GetSize() const _NOEXCEPT {
+			return value_.rows();
+		}
+
+		/// <summary> Gets a diagonal element. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the element. </param>
+		/// <returns> The element. </returns>
+		_CONSTEXPR_FN _T GetElement(const size_t index) const _NOEXCEPT {
+			return value_.diagonal()(index);
+		}
+
+		/// <summary> Sets a diagonal element. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index of the element. </param>
+		/// <param name="value"> The value. </param>
+		_CONSTEXPR_FN void SetElement(const size_t index, const _T value) _NOEXCEPT {
+			value_.diagonal()(index) = value;
+		}
+
+	public:
+		/// <summary>
+		/// 	<para> Destination-passing weighted product <c>out = alpha * op(lhs) * W * op(rhs) + beta * out</c>,
+		/// 	where <c>op</c> optionally transposes, e.g. the normal matrix <c>C^T W C</c>. </para>
+		/// 	<para> Rows of <c>op(rhs)</c> are scaled block by block into a small buffer and accumulated
+		/// 	by GEMM, so the design matrix is read once and never copied. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">			 [in,out] The destination, MUST NOT be lhs or rhs. When beta is
+		/// 	not zero it MUST have the result size, otherwise it is resized. </param>
+		/// <param name="lhs">			 The left operand of any storage order. </param>
+		/// <param name="weight">		 The diagonal weight. </param>
+		/// <param name="rhs">			 The right operand of any storage order. </param>
+		/// <param name="alpha">		 (Optional) Scale of the product. </param>
+		/// <param name="beta">			 (Optional) Scale of the original destination, 0 to ignore it. </param>
+		/// <param name="transpose_lhs"> (Optional) True to use the transpose of lhs. </param>
+		/// <param name="transpose_rhs"> (Optional) True to use the transpose of rhs. </param>
+		template<int _Layout, int _LayoutL, int _LayoutR>
+		static void Multiply(Matrix<_T, _Layout>& out, const Matrix<_T, _LayoutL>& lhs,
+							 const DiagonalMatrix<_T>& weight, const Matrix<_T, _LayoutR>& rhs,
+							 const _T alpha = _T(1), const _T beta = _T(0),
+							 const bool transpose_lhs = false, const bool transpose_rhs = false) {
+			NUDTTK_INSTRUMENT_SCOPE("DiagonalMatrix::Multiply");
+			const typename Matrix<_T, _LayoutL>::base_type& lhs_value = *lhs.value_;
+			const typename Matrix<_T, _LayoutR>::base_type& rhs_value = *rhs.value_;
+			typename Matrix<_T, _Layout>::base_type& value = beta == _T(0) ? out.value_.Overwrite() : out.value_.Mutable();
+			if (beta == _T(0))
+				value.resize(transpose_lhs ? lhs_value.cols() : lhs_value.rows(),
+							 transpose_rhs ? rhs_value.rows() : rhs_value.cols());
+			if (transpose_lhs) {
+				if (transpose_rhs)
+					MultiplyInto(value, lhs_value.transpose(), weight.value_.diagonal(), rhs_value.transpose(), alpha, beta);
+				else
+					MultiplyInto(value, lhs_value.transpose(), weight.value_.diagonal(), rhs_value, alpha, beta);
+			} else {
+				if (transpose_rhs)
+					MultiplyInto(value, lhs_value, weight.value_.diagonal(), rhs_value.transpose(), alpha, beta);
+				else
+					MultiplyInto(value, lhs_value, weight.value_.diagonal(), rhs_value, alpha, beta);
+			}
+		}
+
+		/// <summary> Evaluate the weighted product node <c>lhs * W * rhs</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <typeparam name="_Result"> Type of the result. </typeparam>
+		/// <param name="lhs">    The left value. </param>
+		/// <param name="weight"> The diagonal weight. </param>
+		/// <param name="rhs">    The right value. </param>
+		/// <returns> The product. </returns>
+		template<typename _Result, typename _Lhs, typename _Rhs>
+		static _Result Evaluate(const _Lhs& lhs, const DiagonalMatrix<_T>& weight, const _Rhs& rhs) {
+			NUDTTK_INSTRUMENT_SCOPE("DiagonalMatrix::Evaluate");
+			_Result result(lhs.rows(), rhs.cols());
+			MultiplyInto(result, lhs, weight.value_.diagonal(), rhs, _T(1), _T(0));
+			return result;
+		}
+
+	private:
+		/// <summary> Evaluate <c>out = alpha * lhs * diag(weight) * rhs + beta * out</c>, out has the result size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">    [in,out] The destination. </param>
+		/// <param name="lhs">    The left value or its transpose. </param>
+		/// <param name="weight"> The diagonal. </param>
+		/// <param name="rhs">    The right value or its transpose. </param>
+		/// <param name="alpha">  The product scale. </param>
+		/// <param name="beta">   The destination scale. </param>
+		template<typename _Out, typename _Lhs, typename _Rhs>
+		static void MultiplyInto(_Out& out, const _Lhs& lhs, const diagonal_type& weight, const _Rhs& rhs,
+								 const _T alpha, const _T beta) {
+			if (beta == _T(0))
+				out.setZero();
+			else if (beta != _T(1))
+				out *= beta;
+			// Blocks of scaled rows stay in cache, member call syntax keeps the expression operators of
+			// this namespace out of overload resolution
+			typedef Eigen::Matrix<_T, Eigen::Dynamic, _Rhs::ColsAtCompileTime> scaled_type;
+			const Eigen::Index inner = weight.size();
+			const Eigen::Index block = std::min<Eigen::Index>(inner, 256);
+			scaled_type scaled(block, rhs.cols());
+			for (Eigen::Index k = 0; k < inner; k += block) {
+				const Eigen::Index size = std::min(block, inner - k);
+				scaled.topRows(size).noalias() = weight.segment(k, size).asDiagonal().operator*(rhs.middleRows(k, size));
+				if (alpha != _T(1))
+					scaled.topRows(size) *= alpha;
+				out.noalias() += lhs.middleCols(k, size).operator*(scaled.topRows(size));
+			}
+		}
+
+		// The diagonal
+		base_type value_;
+	};
+
+	/// <summary> Destination-passing weighted product <c>out = alpha * op(lhs) * W * op(rhs) + beta * out</c>. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. See <c>DiagonalMatrix::Multiply</c>. </remarks>
+	/// <param name="out">			 [in,out] The destination, MUST NOT be lhs or rhs. </param>
+	/// <param name="lhs">			 The left operand. </param>
+	/// <param name="weight">		 The diagonal weight. </param>
+	/// <param name="rhs">			 The right operand. </param>
+	/// <param name="alpha">		 (Optional) Scale of the product. </param>
+	/// <param name="beta">			 (Optional) Scale of the original destination, 0 to ignore it. </param>
+	/// <param name="transpose_lhs"> (Optional) True to use the transpose of lhs. </param>
+	/// <param name="transpose_rhs"> (Optional) True to use the transpose of rhs. </param>
+	template<typename _T, int _Layout, int _LayoutL, int _LayoutR>
+	inline void Multiply(Matrix<_T, _Layout>& out, const Matrix<_T, _LayoutL>& lhs,
+						 const DiagonalMatrix<_T>& weight, const Matrix<_T, _LayoutR>& rhs,
+						 const typename Matrix<_T, _Layout>::base_type::Scalar alpha = 1,
+						 const typename Matrix<_T, _Layout>::base_type::Scalar beta = 0,
+						 const bool transpose_lhs = false, const bool transpose_rhs = false) {
+		DiagonalMatrix<_T>::Multiply(out, lhs, weight, rhs, alpha, beta, transpose_lhs, transpose_rhs);
+	}
+}
+
+#endif	// !_NUDTTK_MATH_DIAGONAL_MATRIX_TR_
@@ -0,0 +1,234 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_ELEMENTWISE_TR_
+#define _NUDTTK_MATH_ELEMENTWISE_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+
+#include <type_traits>
+
+#if __cplusplus < 201103L
+#error You need to compile element-wise functions with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> Element-wise function of an operand as an expression node, see <c>Sqrt</c>. </para>
+	/// 	<para> The function is applied to the array of the evaluated operand, so Eigen evaluates it
+	/// 	with its SIMD packet math in one pass. A temporary operand, e.g. <c>A + B</c> in
+	/// 	<c>Sqrt(A + B)</c>, is updated in place and becomes the result. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand">  Type of the operand. </typeparam>
+	/// <typeparam name="_Function"> Type of the function applied to an Eigen array. </typeparam>
+	template<typename _Operand, typename _Function>
+	class unary_op_impl {
+	public:
+		_CONSTEXPR_FN unary_op_impl(const _Operand& operand, const _Function& function) _NOEXCEPT
+			: operand_(operand), function_(function) {}
+
+		_CONSTEXPR_FN const _Operand& operand() const _NOEXCEPT {
+			return operand_;
+		}
+
+		_CONSTEXPR_FN const _Function& function() const _NOEXCEPT {
+			return function_;
+		}
+
+		template<typename _Result>
+		_Result unwrap() const {
+			return apply<_Result>(operand_.template unwrap<_Result>());
+		}
+
+		/// <summary> Apply the function to an evaluated operand. </summary>
+		template<typename _Result, typename _Value>
+		_Result apply(const _Value& value) const {
+			return _Result(function_(value.array()).matrix());
+		}
+
+		template<typename _Result>
+		_Result apply(_Result&& value) const {
+			value.array() = function_(value.array());
+			return std::move(value);
+		}
+
+	private:
+		typename _operand_holder<_Operand>::type operand_;
+		_Function function_;
+	};
+
+	/// <summary>
+	/// 	<para> Evaluation of unwrapped operands of <c>cwise_mul_op_impl</c>. </para>
+	/// 	<para> A temporary operand is multiplied in place and becomes the result. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct cwise_mul_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs.cwiseProduct(rhs);
+		}
+		template<typename _Rhs>
+		static _Result apply(_Result&& lhs, const _Rhs& rhs) {
+			lhs.array() *= rhs.array();
+			return std::move(lhs);
+		}
+		template<typename _Lhs>
+		static _Result apply(const _Lhs& lhs, _Result&& rhs) {
+			rhs.array() *= lhs.array();
+			return std::move(rhs);
+		}
+		static _Result apply(_Result&& lhs, _Result&& rhs) {
+			lhs.array() *= rhs.array();
+			return std::move(lhs);
+		}
+	};
+
+	/// <summary> Evaluation of unwrapped operands of <c>cwise_div_op_impl</c>, reuses a temporary operand. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct cwise_div_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs.cwiseQuotient(rhs);
+		}
+		template<typename _Rhs>
+		static _Result apply(_Result&& lhs, const _Rhs& rhs) {
+			lhs.array() /= rhs.array();
+			return std::move(lhs);
+		}
+		template<typename _Lhs>
+		static _Result apply(const _Lhs& lhs, _Result&& rhs) {
+			// Coefficient-wise, safe when the destination is an operand
+			rhs.array() = lhs.array() / rhs.array();
+			return std::move(rhs);
+		}
+		static _Result apply(_Result&& lhs, _Result&& rhs) {
+			lhs.array() /= rhs.array();
+			return std::move(lhs);
+		}
+	};
+
+	// Coefficient-wise product and quotient, which have no operators
+	CREATE_BINARY_OP_IMPL(cwise_mul_op_impl, *);
+	CREATE_BINARY_OP_IMPL(cwise_div_op_impl, /);
+
+	// An element-wise node has the shape of its (left) operand
+	template<typename _Operand, typename _Function>
+	struct _is_vector_operand<unary_op_impl<_Operand, _Function>> : _is_vector_operand<_Operand> {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<cwise_mul_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Lhs> {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<cwise_div_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Lhs> {};
+
+	/// <summary>
+	/// 	<para> Whether an operand is a matrix, a vector or an expression of them. </para>
+	/// 	<para> Element-wise functions only take such operands, so scalar calls like <c>Abs(-2)</c>
+	/// 	under <c>using namespace NUDTTK</c> still find the scalar overloads. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand"> Type of the operand. </typeparam>
+	template<typename _Operand>
+	struct _is_elementwise_operand : std::false_type {};
+	template<typename _T, int _Layout>
+	struct _is_elementwise_operand<Matrix<_T, _Layout>> : std::true_type {};
+	template<typename _T, int _Size>
+	struct _is_elementwise_operand<Vector<_T, _Size>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<add_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<sub_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<mul_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<div_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<cwise_mul_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_elementwise_operand<cwise_div_op_impl<_Lhs, _Rhs>> : std::true_type {};
+	template<typename _Operand, typename _Function>
+	struct _is_elementwise_operand<unary_op_impl<_Operand, _Function>> : std::true_type {};
+
+	/// <summary> A macro that defines an element-wise function of Eigen arrays and its node function. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="_function"> Name of the node function. </param>
+	/// <param name="_method">	 Method of Eigen arrays. </param>
+#define CREATE_ELEMENTWISE_FUNCTION(_function, _method)							\
+struct _elementwise_##_method {													\
+	template<typename _Array>													\
+	auto operator()(const _Array& x) const -> decltype(x._method()) {			\
+		return x._method();														\
+	}																			\
+};																				\
+template<typename _Operand,													\
+	typename std::enable_if<_is_elementwise_operand<_Operand>::value, int>::type = 0>	\
+_CONSTEXPR_FN unary_op_impl<_Operand, _elementwise_##_method>					\
+	_function(const _Operand& operand) _NOEXCEPT {								\
+	return unary_op_impl<_Operand, _elementwise_##_method>(						\
+		operand, _elementwise_##_method());										\
+}
+
+	// Element-wise functions of a matrix, a vector or an expression, e.g. Sqrt(A + B) * 2.0
+	CREATE_ELEMENTWISE_FUNCTION(Abs, abs);
+	CREATE_ELEMENTWISE_FUNCTION(Square, square);
+	CREATE_ELEMENTWISE_FUNCTION(Sqrt, sqrt);
+	CREATE_ELEMENTWISE_FUNCTION(Exp, exp);
+	CREATE_ELEMENTWISE_FUNCTION(Log, log);
+	CREATE_ELEMENTWISE_FUNCTION(Sin, sin);
+	CREATE_ELEMENTWISE_FUNCTION(Cos, cos);
+	CREATE_ELEMENTWISE_FUNCTION(Tan, tan);
+
+	/// <summary> Element-wise power of Eigen arrays. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the exponent. </typeparam>
+	template<typename _T>
+	struct _elementwise_pow {
+		_T exponent_;
+
+		template<typename _Array>
+		auto operator()(const _Array& x) const -> decltype(x.pow(exponent_)) {
+			return x.pow(exponent_);
+		}
+	};
+
+	/// <summary> Element-wise power of a matrix, a vector or an expression. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="operand">  The operand. </param>
+	/// <param name="exponent"> The exponent. </param>
+	/// <returns> The power node. </returns>
+	template<typename _Operand, typename _T,
+		typename std::enable_if<_is_elementwise_operand<_Operand>::value, int>::type = 0>
+	_CONSTEXPR_FN unary_op_impl<_Operand, _elementwise_pow<_T>> Pow(const _Operand& operand, const _T& exponent) _NOEXCEPT {
+		return unary_op_impl<_Operand, _elementwise_pow<_T>>(operand, _elementwise_pow<_T>{ exponent });
+	}
+
+	/// <summary> Coefficient-wise product of matrices, vectors or expressions of the same shape. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="lhs"> The left operand. </param>
+	/// <param name="rhs"> The right operand. </param>
+	/// <returns> The product node. </returns>
+	template<typename _Lhs, typename _Rhs,
+		typename std::enable_if<_is_elementwise_operand<_Lhs>::value && _is_elementwise_operand<_Rhs>::value, int>::type = 0>
+	_CONSTEXPR_FN cwise_mul_op_impl<_Lhs, _Rhs> CwiseProduct(const _Lhs& lhs, const _Rhs& rhs) _NOEXCEPT {
+		return cwise_mul_op_impl<_Lhs, _Rhs>(lhs, rhs);
+	}
+
+	/// <summary> Coefficient-wise quotient of matrices, vectors or expressions of the same shape. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="lhs"> The dividend. </param>
+	/// <param name="rhs"> The divisor. </param>
+	/// <returns> The quotient node. </returns>
+	template<typename _Lhs, typename _Rhs,
+		typename std::enable_if<_is_elementwise_operand<_Lhs>::value && _is_elementwise_operand<_Rhs>::value, int>::type = 0>
+	_CONSTEXPR_FN cwise_div_op_impl<_Lhs, _Rhs> CwiseQuotient(const _Lhs& lhs, const _Rhs& rhs) _NOEXCEPT {
+		return cwise_div_op_impl<_Lhs, _Rhs>(lhs, rhs);
+	}
+}
+
+#endif	// !_NUDTTK_MATH_ELEMENTWISE_TR_
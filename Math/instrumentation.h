@@ -0,0 +1,922 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_INSTRUMENTATION_TR_
+#define _NUDTTK_MATH_INSTRUMENTATION_TR_
+
+#include "common.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+// Instrumentation is compile-time optional, define NUDTTK_ENABLE_INSTRUMENTATION before including
+// any header of this library to enable it. When disabled, every instrumentation macro expands to
+// nothing and the snapshot API always returns an empty snapshot.
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+#if __cplusplus < 201103L
+#error You need to compile instrumentation with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif	// _MSC_VER
+
+// Report Eigen dense storage and product temporaries, the plugin must be seen before Eigen is included.
+// Eigen runs it in the member functions of every DenseStorage, where DenseStorage is the injected class
+// name of the storage type, which is reported only if its size is dynamic, i.e. the coefficients are on
+// the heap. The product kernels run it as well, there DenseStorage names the class template and the
+// temporary is reported only beyond the size Eigen puts on the stack, counted as double since Eigen
+// only exposes the number of coefficients.
+#ifndef EIGEN_DENSE_STORAGE_CTOR_PLUGIN
+#define EIGEN_DENSE_STORAGE_CTOR_PLUGIN ::NUDTTK::Instrumentation::_on_dense_storage_allocated<DenseStorage>(size, 0);
+#endif	// EIGEN_DENSE_STORAGE_CTOR_PLUGIN
+
+namespace Eigen {
+	template<typename T, int Size, int _Rows, int _Cols, int _Options> class DenseStorage;
+}
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+
+namespace NUDTTK {
+	namespace Instrumentation {
+
+		/// <summary> Accumulated statistics of an instrumented operation. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct OperationStats {
+			std::string name;				// Operation name, e.g. "Matrix::Inv"
+			unsigned long long calls;		// Number of calls
+			unsigned long long total_ns;	// Total (inclusive) time in nanoseconds
+			unsigned long long max_ns;		// Longest single call in nanoseconds
+		};
+
+		/// <summary> Hit and miss statistics of a lazy evaluation cache entry. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct CacheStats {
+			std::string name;				// Cache entry name, e.g. "inverse_value"
+			unsigned long long hits;		// Number of cached values returned
+			unsigned long long misses;		// Number of values (re)computed
+
+			/// <summary> Hit rate in [0, 1], 0 when never queried. </summary>
+			double HitRate() const {
+				return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+			}
+		};
+
+		/// <summary>
+		/// 	<para> Heap allocation statistics of a library entry point. </para>
+		/// 	<para> Allocations are attributed to the outermost instrumented scope, i.e. the function
+		/// 	the caller actually invoked. Frees are not observable through Eigen, so no live volume or
+		/// 	peak is kept, only the largest volume allocated by a single call. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct AllocationStats {
+			std::string name;				// Entry point name, e.g. "Math::PolyFit"
+			unsigned long long calls;		// Number of completed calls
+			unsigned long long allocations;	// Number of heap allocations
+			unsigned long long bytes;		// Total bytes allocated
+			unsigned long long max_call_bytes;	// Most bytes allocated by a single call
+		};
+
+		/// <summary> A point-in-time copy of all instrumentation counters. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct Snapshot {
+			std::vector<OperationStats> operations;
+			std::vector<CacheStats> caches;
+			std::vector<AllocationStats> allocations;
+
+			/// <summary> Find operation statistics by name. </summary>
+			/// <param name="name"> The operation name. </param>
+			/// <returns> The statistics, all zero when the operation was never called. </returns>
+			OperationStats Operation(const std::string& name) const {
+				for (size_t i = 0; i < operations.size(); i++) {
+					if (operations[i].name == name)
+						return operations[i];
+				}
+				OperationStats empty = { name, 0, 0, 0 };
+				return empty;
+			}
+
+			/// <summary> Find cache statistics by name. </summary>
+			/// <param name="name"> The cache entry name. </param>
+			/// <returns> The statistics, all zero when the cache was never queried. </returns>
+			CacheStats Cache(const std::string& name) const {
+				for (size_t i = 0; i < caches.size(); i++) {
+					if (caches[i].name == name)
+						return caches[i];
+				}
+				CacheStats empty = { name, 0, 0 };
+				return empty;
+			}
+
+			/// <summary> Find allocation statistics by entry point name. </summary>
+			/// <param name="name"> The entry point name. </param>
+			/// <returns> The statistics, all zero when the entry point was never called. </returns>
+			AllocationStats Allocation(const std::string& name) const {
+				for (size_t i = 0; i < allocations.size(); i++) {
+					if (allocations[i].name == name)
+						return allocations[i];
+				}
+				AllocationStats empty = { name, 0, 0, 0, 0 };
+				return empty;
+			}
+		};
+
+		/// <summary>
+		/// 	<para> Observer of heap allocations made inside library entry points. </para>
+		/// 	<para> Callbacks run on the allocating thread, allocations made by the observer itself
+		/// 	are not reported again. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class AllocationObserver {
+		public:
+			virtual ~AllocationObserver() {}
+
+			/// <summary> Called on every heap allocation. </summary>
+			/// <param name="entry_point"> The entry point that caused the allocation. </param>
+			/// <param name="bytes">	   The allocated bytes. </param>
+			virtual void OnAllocation(const char* /*entry_point*/, std::size_t /*bytes*/) {}
+
+			/// <summary> Called when an entry point returns. </summary>
+			/// <param name="entry_point"> The entry point. </param>
+			/// <param name="allocations"> Number of heap allocations made by the call. </param>
+			/// <param name="bytes">	   Bytes allocated by the call. </param>
+			virtual void OnReturn(const char* /*entry_point*/, unsigned long long /*allocations*/, unsigned long long /*bytes*/) {}
+		};
+
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+		/// <summary> Counters of one instrumented call site, updated lock-free. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _operation_site {
+		public:
+			explicit _operation_site(const char* name) _NOEXCEPT;
+
+			void Record(const std::uint64_t elapsed_ns) _NOEXCEPT {
+				calls_.fetch_add(1, std::memory_order_relaxed);
+				total_ns_.fetch_add(elapsed_ns, std::memory_order_relaxed);
+				std::uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+				while (elapsed_ns > max_ns
+					   && !max_ns_.compare_exchange_weak(max_ns, elapsed_ns, std::memory_order_relaxed)) {
+				}
+			}
+
+			void Reset() _NOEXCEPT {
+				calls_.store(0, std::memory_order_relaxed);
+				total_ns_.store(0, std::memory_order_relaxed);
+				max_ns_.store(0, std::memory_order_relaxed);
+			}
+
+			const char* name_;
+			std::atomic<std::uint64_t> calls_;
+			std::atomic<std::uint64_t> total_ns_;
+			std::atomic<std::uint64_t> max_ns_;
+		};
+
+		/// <summary> Counters of one lazy evaluation cache entry, updated lock-free. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _cache_site {
+		public:
+			explicit _cache_site(const char* name) _NOEXCEPT;
+
+			void Record(const bool hit) _NOEXCEPT {
+				(hit ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void Reset() _NOEXCEPT {
+				hits_.store(0, std::memory_order_relaxed);
+				misses_.store(0, std::memory_order_relaxed);
+			}
+
+			const char* name_;
+			std::atomic<std::uint64_t> hits_;
+			std::atomic<std::uint64_t> misses_;
+		};
+
+		/// <summary> The default allocation observer, accumulates <c>AllocationStats</c> per entry point. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _allocation_recorder : public AllocationObserver {
+		public:
+			static _allocation_recorder& Instance() _NOEXCEPT {
+				static _allocation_recorder instance;
+				return instance;
+			}
+
+			virtual void OnReturn(const char* entry_point, unsigned long long allocations, unsigned long long bytes) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				AllocationStats& stats = stats_[entry_point];
+				stats.name = entry_point;
+				stats.calls++;
+				stats.allocations += allocations;
+				stats.bytes += bytes;
+				stats.max_call_bytes = std::max(stats.max_call_bytes, bytes);
+			}
+
+			std::vector<AllocationStats> Stats() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				std::vector<AllocationStats> stats;
+				for (auto& entry : stats_)
+					stats.push_back(entry.second);
+				return stats;
+			}
+
+			void Reset() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				stats_.clear();
+			}
+
+		private:
+			_allocation_recorder() {}
+
+			std::mutex mutex_;
+			std::map<std::string, AllocationStats> stats_;
+		};
+
+		/// <summary> The installed allocation observer, the recorder by default. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline std::atomic<AllocationObserver*>& _allocation_observer() _NOEXCEPT {
+			static std::atomic<AllocationObserver*> observer(&_allocation_recorder::Instance());
+			return observer;
+		}
+
+		/// <summary> Per thread allocation state of the entry point being executed. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct _allocation_context {
+			const char* entry_point;		// Outermost instrumented scope
+			unsigned depth;					// Nesting depth of instrumented scopes
+			bool reporting;					// Inside an observer callback
+			unsigned long long allocations;
+			unsigned long long bytes;
+		};
+
+		inline _allocation_context& _current_allocation_context() _NOEXCEPT {
+			static thread_local _allocation_context context = { nullptr, 0, false, 0, 0 };
+			return context;
+		}
+
+		/// <summary> Report a heap allocation to the observer, ignored outside library entry points. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="bytes"> The allocated bytes. </param>
+		inline void _report_allocation(const std::size_t bytes) {
+			_allocation_context& context = _current_allocation_context();
+			if (context.depth == 0 || context.reporting)
+				return;
+			context.reporting = true;
+			context.allocations++;
+			context.bytes += bytes;
+			AllocationObserver* observer = _allocation_observer().load(std::memory_order_acquire);
+			if (observer)
+				observer->OnAllocation(context.entry_point, bytes);
+			context.reporting = false;
+		}
+
+		/// <summary> Whether an Eigen storage type holds its coefficients on the heap. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		template<typename _Storage>
+		struct _dense_storage_traits {
+			static _CONSTEXPR bool heap = false;
+		};
+
+		template<typename _T, int _Rows, int _Cols, int _Options>
+		struct _dense_storage_traits<Eigen::DenseStorage<_T, -1 /* Eigen::Dynamic */, _Rows, _Cols, _Options>> {
+			static _CONSTEXPR bool heap = true;
+			typedef _T value_type;
+		};
+
+		template<typename _Storage, bool _Heap = _dense_storage_traits<_Storage>::heap>
+		struct _dense_storage_reporter {
+			static void Report(const std::ptrdiff_t /*size*/) _NOEXCEPT {}
+		};
+
+		template<typename _Storage>
+		struct _dense_storage_reporter<_Storage, true> {
+			static void Report(const std::ptrdiff_t size) {
+				if (size > 0)
+					_report_allocation(static_cast<std::size_t>(size) * sizeof(typename _dense_storage_traits<_Storage>::value_type));
+			}
+		};
+
+		/// <summary> Eigen dense storage constructor plugin, reported if the storage is on the heap. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size"> Number of coefficients. </param>
+		template<typename _Storage>
+		inline void _on_dense_storage_allocated(const std::ptrdiff_t size, int) {
+			_dense_storage_reporter<_Storage>::Report(size);
+		}
+
+		/// <summary> Eigen product temporary plugin, on the heap only beyond the stack allocation limit. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size"> Number of coefficients. </param>
+		template<template<typename, int, int, int, int> class _Storage>
+		inline void _on_dense_storage_allocated(const std::ptrdiff_t size, ...) {
+#ifdef EIGEN_STACK_ALLOCATION_LIMIT
+			const std::size_t limit = EIGEN_STACK_ALLOCATION_LIMIT;
+#else
+			const std::size_t limit = 128 * 1024;	// The default of Eigen
+#endif	// EIGEN_STACK_ALLOCATION_LIMIT
+			const std::size_t bytes = static_cast<std::size_t>(size > 0 ? size : 0) * sizeof(double);
+			if (bytes > limit)
+				_report_allocation(bytes);
+		}
+
+		/// <summary> Registry of all call sites, only locked on registration and snapshot. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _registry {
+		public:
+			static _registry& Instance() _NOEXCEPT {
+				static _registry instance;
+				return instance;
+			}
+
+			void Register(_operation_site* site) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				operation_sites_.push_back(site);
+			}
+
+			void Register(_cache_site* site) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				cache_sites_.push_back(site);
+			}
+
+			Snapshot TakeSnapshot() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				// Several sites may share one name (overloads, template instantiations), merge them
+				std::map<std::string, OperationStats> operations;
+				for (size_t i = 0; i < operation_sites_.size(); i++) {
+					const _operation_site& site = *operation_sites_[i];
+					OperationStats& stats = operations[site.name_];
+					stats.name = site.name_;
+					stats.calls += site.calls_.load(std::memory_order_relaxed);
+					stats.total_ns += site.total_ns_.load(std::memory_order_relaxed);
+					stats.max_ns = std::max<unsigned long long>(stats.max_ns, site.max_ns_.load(std::memory_order_relaxed));
+				}
+				std::map<std::string, CacheStats> caches;
+				for (size_t i = 0; i < cache_sites_.size(); i++) {
+					const _cache_site& site = *cache_sites_[i];
+					CacheStats& stats = caches[site.name_];
+					stats.name = site.name_;
+					stats.hits += site.hits_.load(std::memory_order_relaxed);
+					stats.misses += site.misses_.load(std::memory_order_relaxed);
+				}
+
+				Snapshot snapshot;
+				for (auto& operation : operations)
+					snapshot.operations.push_back(operation.second);
+				for (auto& cache : caches)
+					snapshot.caches.push_back(cache.second);
+				snapshot.allocations = _allocation_recorder::Instance().Stats();
+				return snapshot;
+			}
+
+			void Reset() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (size_t i = 0; i < operation_sites_.size(); i++)
+					operation_sites_[i]->Reset();
+				for (size_t i = 0; i < cache_sites_.size(); i++)
+					cache_sites_[i]->Reset();
+				_allocation_recorder::Instance().Reset();
+			}
+
+		private:
+			_registry() {}
+
+			std::mutex mutex_;
+			std::vector<_operation_site*> operation_sites_;
+			std::vector<_cache_site*> cache_sites_;
+		};
+
+		inline _operation_site::_operation_site(const char* name) _NOEXCEPT
+			: name_(name), calls_(0), total_ns_(0), max_ns_(0) {
+			_registry::Instance().Register(this);
+		}
+
+		inline _cache_site::_cache_site(const char* name) _NOEXCEPT
+			: name_(name), hits_(0), misses_(0) {
+			_registry::Instance().Register(this);
+		}
+
+		/// <summary>
+		/// 	<para> Get the call site of an instrumented scope. </para>
+		/// 	<para> Instrumented functions are mostly <c>constexpr</c> which can not hold static variables,
+		/// 	so every site is identified by a local tag type instead. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <typeparam name="_Tag"> Local tag type, provides <c>name()</c>. </typeparam>
+		template<typename _Tag>
+		inline _operation_site& _operation_site_of() _NOEXCEPT {
+			static _operation_site site(_Tag::name());
+			return site;
+		}
+
+		/// <summary> Get the site of a lazy evaluation cache entry. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <typeparam name="_Tag"> Local tag type, provides <c>name()</c>. </typeparam>
+		template<typename _Tag>
+		inline _cache_site& _cache_site_of() _NOEXCEPT {
+			static _cache_site site(_Tag::name());
+			return site;
+		}
+
+		/// <summary> A completed span of an instrumented operation. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct _trace_event {
+			const char* name;
+			std::int64_t start_ns;			// Since the trace epoch
+			std::int64_t duration_ns;
+		};
+
+		/// <summary>
+		/// 	<para> Lock-free ring buffer of the spans of one thread. </para>
+		/// 	<para> The owning thread is the only producer, the oldest spans are overwritten when full.
+		/// 	Every slot is a seqlock: its sequence is odd while the span is written and 2 (i + 1) once span
+		/// 	i is complete, so a reader keeps only the spans whose sequence is the same before and after
+		/// 	reading them, and never a span half written or overwritten meanwhile. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _trace_buffer {
+		public:
+			_trace_buffer(const unsigned thread_index, const size_t capacity)
+				: thread_index_(thread_index), capacity_(std::max<size_t>(capacity, 1)),
+				  slots_(new _slot[std::max<size_t>(capacity, 1)]()), head_(0), tail_(0) {}
+
+			void Push(const _trace_event& event) _NOEXCEPT {
+				const std::uint64_t head = head_.load(std::memory_order_relaxed);
+				_slot& slot = slots_[static_cast<size_t>(head % capacity_)];
+				slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				slot.name.store(event.name, std::memory_order_relaxed);
+				slot.start_ns.store(event.start_ns, std::memory_order_relaxed);
+				slot.duration_ns.store(event.duration_ns, std::memory_order_relaxed);
+				slot.sequence.store(2 * head + 2, std::memory_order_release);
+				head_.store(head + 1, std::memory_order_release);
+			}
+
+			void Collect(std::vector<_trace_event>& events) const {
+				const std::uint64_t head = head_.load(std::memory_order_acquire);
+				const std::uint64_t first = std::max(tail_.load(std::memory_order_relaxed), head > capacity_ ? head - capacity_ : 0);
+				for (std::uint64_t i = first; i < head; i++) {
+					const _slot& slot = slots_[static_cast<size_t>(i % capacity_)];
+					if (slot.sequence.load(std::memory_order_acquire) != 2 * i + 2)
+						continue;
+					const _trace_event event = {
+						slot.name.load(std::memory_order_relaxed),
+						slot.start_ns.load(std::memory_order_relaxed),
+						slot.duration_ns.load(std::memory_order_relaxed)
+					};
+					// Dropped if the producer has started to overwrite the slot meanwhile
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (slot.sequence.load(std::memory_order_relaxed) == 2 * i + 2)
+						events.push_back(event);
+				}
+			}
+
+			void Clear() _NOEXCEPT {
+				tail_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+			}
+
+			const unsigned thread_index_;
+
+		private:
+			struct _slot {
+				std::atomic<std::uint64_t> sequence;
+				std::atomic<const char*> name;
+				std::atomic<std::int64_t> start_ns;
+				std::atomic<std::int64_t> duration_ns;
+			};
+
+			const std::uint64_t capacity_;
+			const std::unique_ptr<_slot[]> slots_;
+			std::atomic<std::uint64_t> head_;
+			std::atomic<std::uint64_t> tail_;
+		};
+
+		/// <summary> Collects spans of all threads and writes them in Chrome trace event format. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class _tracer {
+		public:
+			static _tracer& Instance() _NOEXCEPT {
+				static _tracer instance;
+				return instance;
+			}
+
+			bool Active() const _NOEXCEPT {
+				return active_.load(std::memory_order_relaxed);
+			}
+
+			void Start(const size_t events_per_thread) _NOEXCEPT {
+				capacity_.store(events_per_thread, std::memory_order_relaxed);
+				active_.store(true, std::memory_order_release);
+			}
+
+			void Stop() _NOEXCEPT {
+				active_.store(false, std::memory_order_release);
+			}
+
+			void Record(const char* name,
+						const std::chrono::steady_clock::time_point& start,
+						const std::chrono::steady_clock::duration& elapsed) {
+				_trace_event event = {
+					name,
+					std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch_).count(),
+					std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+				};
+				ThreadBuffer().Push(event);
+			}
+
+			void Clear() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (size_t i = 0; i < buffers_.size(); i++)
+					buffers_[i]->Clear();
+			}
+
+			void Write(std::ostream& os) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				const std::ios_base::fmtflags flags = os.flags();
+				const std::streamsize precision = os.precision();
+				os << std::fixed << std::setprecision(3);
+
+				os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+				bool first = true;
+				std::vector<_trace_event> events;
+				for (size_t i = 0; i < buffers_.size(); i++) {
+					const unsigned tid = buffers_[i]->thread_index_;
+					os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+					   << ",\"args\":{\"name\":\"Thread " << tid << "\"}}";
+					first = false;
+
+					events.clear();
+					buffers_[i]->Collect(events);
+					for (size_t j = 0; j < events.size(); j++) {
+						// Chrome trace timestamps are in microseconds
+						os << ",\n{\"name\":\"";
+						for (const char* c = events[j].name; *c; c++)
+							os << (*c == '"' || *c == '\\' ? "\\" : "") << *c;
+						os << "\",\"cat\":\"NUDTTK\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+						   << ",\"ts\":" << events[j].start_ns / 1000.0 << ",\"dur\":" << events[j].duration_ns / 1000.0 << "}";
+					}
+				}
+				os << "\n]}\n";
+
+				os.flags(flags);
+				os.precision(precision);
+			}
+
+		private:
+			_tracer() : active_(false), capacity_(0), epoch_(std::chrono::steady_clock::now()) {}
+
+			_trace_buffer& ThreadBuffer() {
+				// Buffers are owned by the tracer as well, spans of finished threads are kept
+				static thread_local std::shared_ptr<_trace_buffer> buffer;
+				if (!buffer) {
+					std::lock_guard<std::mutex> lock(mutex_);
+					buffer = std::make_shared<_trace_buffer>(static_cast<unsigned>(buffers_.size() + 1),
+															 capacity_.load(std::memory_order_relaxed));
+					buffers_.push_back(buffer);
+				}
+				return *buffer;
+			}
+
+			std::atomic<bool> active_;
+			std::atomic<size_t> capacity_;
+			const std::chrono::steady_clock::time_point epoch_;
+			std::mutex mutex_;
+			std::vector<std::shared_ptr<_trace_buffer> > buffers_;
+		};
+
+		/// <summary>
+		/// 	<para> Scoped operation, records the elapsed time of the enclosing scope on destruction, and a
+		/// 	span of it while tracing. </para>
+		/// 	<para> The outermost operation of a thread is the entry point heap allocations are attributed to. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		class ScopedOperation {
+		public:
+			explicit ScopedOperation(_operation_site& site) _NOEXCEPT
+				: site_(site), start_(std::chrono::steady_clock::now()) {
+				_allocation_context& context = _current_allocation_context();
+				if (context.depth++ == 0) {
+					context.entry_point = site.name_;
+					context.allocations = 0;
+					context.bytes = 0;
+				}
+			}
+
+			~ScopedOperation() {
+				const auto elapsed = std::chrono::steady_clock::now() - start_;
+				site_.Record(static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+				_allocation_context& context = _current_allocation_context();
+				if (_tracer::Instance().Active()) {
+					// The first span of a thread allocates its buffer, which is not the operation's
+					const bool reporting = context.reporting;
+					context.reporting = true;
+					_tracer::Instance().Record(site_.name_, start_, elapsed);
+					context.reporting = reporting;
+				}
+				if (--context.depth == 0 && !context.reporting) {
+					AllocationObserver* observer = _allocation_observer().load(std::memory_order_acquire);
+					if (observer) {
+						context.reporting = true;
+						observer->OnReturn(context.entry_point, context.allocations, context.bytes);
+						context.reporting = false;
+					}
+				}
+			}
+
+		private:
+			ScopedOperation(const ScopedOperation&);
+			ScopedOperation& operator=(const ScopedOperation&);
+
+			_operation_site& site_;
+			std::chrono::steady_clock::time_point start_;
+		};
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+
+		/// <summary> Whether instrumentation is compiled in. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline bool Enabled() _NOEXCEPT {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			return true;
+#else
+			return false;
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Take a snapshot of all counters, timers and cache statistics. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The snapshot, empty when instrumentation is disabled. </returns>
+		inline Snapshot TakeSnapshot() {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			return _registry::Instance().TakeSnapshot();
+#else
+			return Snapshot();
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Reset all counters, timers, cache and allocation statistics to zero. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline void Reset() {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			_registry::Instance().Reset();
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Get the default allocation observer which feeds <c>Snapshot::allocations</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The observer, nullptr when instrumentation is disabled. </returns>
+		inline AllocationObserver* DefaultAllocationObserver() _NOEXCEPT {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			return &_allocation_recorder::Instance();
+#else
+			return nullptr;
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Install an allocation observer for all threads. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="observer"> The observer, nullptr stops reporting. </param>
+		/// <returns> The previous observer. </returns>
+		inline AllocationObserver* SetAllocationObserver(AllocationObserver* observer) _NOEXCEPT {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			return _allocation_observer().exchange(observer, std::memory_order_acq_rel);
+#else
+			(void)observer;
+			return nullptr;
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary>
+		/// 	<para> Start recording a span of every instrumented operation. </para>
+		/// 	<para> Spans are kept in a ring buffer per thread, the oldest ones are overwritten when full. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="events_per_thread"> (Optional) Capacity of the buffers of threads that have not traced yet. </param>
+		inline void StartTracing(const size_t events_per_thread = 65536) {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			_tracer::Instance().Start(events_per_thread);
+#else
+			(void)events_per_thread;
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Stop recording spans, recorded spans are kept. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline void StopTracing() {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			_tracer::Instance().Stop();
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary> Discard all recorded spans. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline void ClearTrace() {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			_tracer::Instance().Clear();
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+
+		/// <summary>
+		/// 	<para> Write the recorded spans in Chrome trace event format (JSON). </para>
+		/// 	<para> The output can be opened in chrome://tracing or https://ui.perfetto.dev, one track per thread. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="os"> [in,out] The output stream. </param>
+		inline void WriteChromeTrace(std::ostream& os) {
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+			_tracer::Instance().Write(os);
+#else
+			os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n";
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+		}
+	}	// namespace Instrumentation
+}	// namespace NUDTTK
+
+#define _NUDTTK_INSTRUMENT_CONCAT_IMPL(_lhs, _rhs) _lhs##_rhs
+#define _NUDTTK_INSTRUMENT_CONCAT(_lhs, _rhs) _NUDTTK_INSTRUMENT_CONCAT_IMPL(_lhs, _rhs)
+
+#ifdef NUDTTK_ENABLE_INSTRUMENTATION
+/// <summary> A macro that counts and times the enclosing scope as operation <c>_name</c>, and tracks its heap allocations. </summary>
+/// <remarks> Blue Wing, 2026/10/19. </remarks>
+/// <param name="_name"> The operation name (string literal). </param>
+#define NUDTTK_INSTRUMENT_SCOPE(_name)																\
+struct _NUDTTK_INSTRUMENT_CONCAT(_nudttk_scope_tag_, __LINE__) {									\
+	static const char* name() { return _name; }														\
+};																									\
+::NUDTTK::Instrumentation::ScopedOperation _NUDTTK_INSTRUMENT_CONCAT(_nudttk_scope_, __LINE__)(		\
+	::NUDTTK::Instrumentation::_operation_site_of<_NUDTTK_INSTRUMENT_CONCAT(_nudttk_scope_tag_, __LINE__)>())
+
+/// <summary> A macro that records a hit or miss of lazy evaluation cache entry <c>_name</c>. </summary>
+/// <remarks> Blue Wing, 2026/10/19. </remarks>
+/// <param name="_name"> The cache entry name (string literal). </param>
+/// <param name="_hit">	 True if the cached value is reused. </param>
+#define NUDTTK_INSTRUMENT_CACHE(_name, _hit)														\
+struct _NUDTTK_INSTRUMENT_CONCAT(_nudttk_cache_tag_, __LINE__) {									\
+	static const char* name() { return _name; }														\
+};																									\
+::NUDTTK::Instrumentation::_cache_site_of<_NUDTTK_INSTRUMENT_CONCAT(_nudttk_cache_tag_, __LINE__)>().Record(_hit)
+
+// A scope operation is not a literal type, so a non-template function instrumented by
+// NUDTTK_INSTRUMENT_SCOPE is only constexpr (_CONSTEXPR_FN_A) if instrumentation is compiled out
+#define _CONSTEXPR_FN_I
+#else
+#define NUDTTK_INSTRUMENT_SCOPE(_name)
+#define NUDTTK_INSTRUMENT_CACHE(_name, _hit)
+#define _CONSTEXPR_FN_I		_CONSTEXPR_FN_A
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION
+
+// Allocations through operator new (std containers, new[]) are only visible when the global operators
+// are replaced, define NUDTTK_INSTRUMENT_GLOBAL_NEW in exactly one translation unit to do so.
+#if defined(NUDTTK_ENABLE_INSTRUMENTATION) && defined(NUDTTK_INSTRUMENT_GLOBAL_NEW)
+#ifdef _MSC_VER
+#define _NOINLINE_FN		__declspec(noinline)
+#else
+#define _NOINLINE_FN		__attribute__((noinline))
+#endif	// _MSC_VER
+
+namespace NUDTTK {
+	namespace Instrumentation {
+		// Every replaced operator delete frees through these, out of line so that the compiler does not
+		// pair the inlined free with the new expression of the caller (-Wmismatched-new-delete)
+		_NOINLINE_FN void _deallocate(void* ptr) _NOEXCEPT {
+			std::free(ptr);
+		}
+
+#ifdef __cpp_aligned_new
+		_NOINLINE_FN void _deallocate_aligned(void* ptr) _NOEXCEPT {
+#ifdef _MSC_VER
+			_aligned_free(ptr);
+#else
+			std::free(ptr);
+#endif	// _MSC_VER
+		}
+#endif	// __cpp_aligned_new
+	}
+}
+
+#undef _NOINLINE_FN
+
+void* operator new(std::size_t size) {
+	::NUDTTK::Instrumentation::_report_allocation(size);
+	for (;;) {
+		void* ptr = std::malloc(size == 0 ? 1 : size);
+		if (ptr)
+			return ptr;
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) _NOEXCEPT {
+	try {
+		return ::operator new(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) _NOEXCEPT {
+	return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+void operator delete[](void* ptr) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate(ptr);
+}
+
+#ifdef __cpp_aligned_new
+// Over-aligned types, e.g. fixed-size vectorizable Eigen members, are allocated through these
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	::NUDTTK::Instrumentation::_report_allocation(size);
+	const std::size_t align = static_cast<std::size_t>(alignment);
+	for (;;) {
+#ifdef _MSC_VER
+		void* ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+		// The size of aligned_alloc MUST be a multiple of the alignment
+		void* ptr = std::aligned_alloc(align, size == 0 ? align : (size + align - 1) / align * align);
+#endif	// _MSC_VER
+		if (ptr)
+			return ptr;
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) _NOEXCEPT {
+	try {
+		return ::operator new(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) _NOEXCEPT {
+	return ::operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* ptr, std::align_val_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) _NOEXCEPT {
+	::NUDTTK::Instrumentation::_deallocate_aligned(ptr);
+}
+#endif	// __cpp_aligned_new
+#endif	// NUDTTK_ENABLE_INSTRUMENTATION && NUDTTK_INSTRUMENT_GLOBAL_NEW
+
+#endif	// #ifndef _NUDTTK_MATH_INSTRUMENTATION_TR_
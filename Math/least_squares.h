@@ -0,0 +1,217 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_LEAST_SQUARES_TR_
+#define _NUDTTK_MATH_LEAST_SQUARES_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+
+#include <limits>
+#include <algorithm>
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> Least squares solver of <c>min |A x - b|</c> by an orthogonal factorization of the
+	/// 	design matrix A, which is computed once and reused for every right-hand side. </para>
+	/// 	<para> Unlike the normal equation <c>(A^T A)^-1 A^T b</c> it does not square the condition
+	/// 	number, so high polynomial orders stay accurate, and it costs no explicit inverse. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T = double>
+	class LeastSquares {
+	public:
+		/// <summary> Factorization of the design matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		enum Method {
+			QR,			// Householder QR, the fastest, for a design matrix of full column rank
+			ColPivQR,	// Householder QR with column pivoting, a basic solution if rank deficient
+			COD			// Complete orthogonal decomposition, the minimum norm solution if rank deficient
+		};
+
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic> dense_type;
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, 1> vector_type;
+
+	public:
+		/// <summary> Factorize the design matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="design">	 The design matrix of any storage order, at least as many rows as columns. </param>
+		/// <param name="method">	 (Optional) The factorization, column pivoting QR by default. </param>
+		/// <param name="threshold"> (Optional) Threshold of the rank relative to the largest pivot,
+		/// 	negative (default) for the smaller size of the design matrix times the machine epsilon. </param>
+		template<int _Layout>
+		explicit LeastSquares(const Matrix<_T, _Layout>& design, const Method method = ColPivQR, const _T threshold = _T(-1))
+			: method_(method), rows_(design.GetNumRows()), cols_(design.GetNumColumns()), rank_(0) {
+			NUDTTK_INSTRUMENT_SCOPE("LeastSquares::Compute");
+			Compute(design.unwrap(), threshold);
+		}
+
+		/// <summary> Factorize the design matrix on an array without copying it first. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="design">	 The design matrix given column by column, e.g. the powers of the
+		/// 	abscissae of a polynomial fit. The caller MUST ensure there are rows * cols values. </param>
+		/// <param name="rows">		 Number of the rows, at least the number of the columns. </param>
+		/// <param name="cols">		 Number of the columns. </param>
+		/// <param name="method">	 (Optional) The factorization, column pivoting QR by default. </param>
+		/// <param name="threshold"> (Optional) Threshold of the rank, see above. </param>
+		LeastSquares(const _T design[], const size_t rows, const size_t cols,
+					 const Method method = ColPivQR, const _T threshold = _T(-1))
+			: method_(method), rows_(rows), cols_(cols), rank_(0) {
+			NUDTTK_INSTRUMENT_SCOPE("LeastSquares::Compute");
+			Compute(Eigen::Map<const dense_type>(design, static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols)),
+					threshold);
+		}
+
+	public:
+		/// <summary> Gets the factorization. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN Method GetMethod() const _NOEXCEPT {
+			return method_;
+		}
+
+		/// <summary> Gets the number of rows (observations) of the design matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN size_t GetNumRows() const _NOEXCEPT {
+			return rows_;
+		}
+
+		/// <summary> Gets the number of columns (parameters) of the design matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN size_t GetNumColumns() const _NOEXCEPT {
+			return cols_;
+		}
+
+		/// <summary> Gets the numerical rank of the design matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN size_t GetRank() const _NOEXCEPT {
+			return rank_;
+		}
+
+		/// <summary> Whether the parameters are determined, i.e. the design matrix has full column rank. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN bool IsFullRank() const _NOEXCEPT {
+			return rank_ == cols_;
+		}
+
+		/// <summary> Solve for a right-hand side. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand side (observations). </param>
+		/// <returns> The solution (parameters), empty if the size of b is not the rows. </returns>
+		Vector<_T> Solve(const Vector<_T>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("LeastSquares::Solve");
+			if (b.GetSize() != rows_)
+				return Vector<_T>();
+			vector_type x;
+			SolveInto(b.unwrap(), x);
+			return Vector<_T>(x);
+		}
+
+		/// <summary> Solve for multiple right-hand sides as the columns of a matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand sides of any storage order. </param>
+		/// <returns> The solutions as the columns, empty if the rows of b are not the rows. </returns>
+		template<int _Layout>
+		Matrix<_T, _Layout> Solve(const Matrix<_T, _Layout>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("LeastSquares::Solve");
+			if (b.GetNumRows() != rows_)
+				return Matrix<_T, _Layout>();
+			dense_type x;
+			SolveInto(b.unwrap(), x);
+			return Matrix<_T, _Layout>(typename Matrix<_T, _Layout>::base_type(x));
+		}
+
+		/// <summary> Solve for a right-hand side on arrays without copying. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand side, the caller MUST ensure there are as many values as rows. </param>
+		/// <param name="x"> [out] The solution, the caller MUST ensure there are as many values as columns. </param>
+		void Solve(const _T b[], _T x[]) const {
+			NUDTTK_INSTRUMENT_SCOPE("LeastSquares::Solve");
+			const Eigen::Map<const vector_type> b_map(b, static_cast<Eigen::Index>(rows_));
+			Eigen::Map<vector_type> x_map(x, static_cast<Eigen::Index>(cols_));
+			SolveInto(b_map, x_map);
+		}
+
+	private:
+		template<typename _Design>
+		void Compute(const _Design& design, const _T threshold) {
+			const _T relative = threshold < _T(0)
+				? static_cast<_T>(std::min(rows_, cols_)) * std::numeric_limits<_T>::epsilon() : threshold;
+			switch (method_) {
+			case QR:
+				Factorize(design, "least_squares_qr", qr_);
+				if (std::min(rows_, cols_) > 0) {
+					// Without pivoting the rank is estimated from the diagonal of R, empty without rows
+					const vector_type diagonal = qr_.matrixQR().diagonal().cwiseAbs();
+					rank_ = static_cast<size_t>((diagonal.array() > relative * diagonal.maxCoeff()).count());
+				}
+				break;
+			case ColPivQR:
+				// The threshold only decides the rank, the factorization does not depend on it
+				Factorize(design, "least_squares_col_piv_qr", col_piv_qr_);
+				col_piv_qr_.setThreshold(relative);
+				rank_ = static_cast<size_t>(col_piv_qr_.rank());
+				break;
+			case COD:
+				cod_.setThreshold(relative);
+				if (threshold < _T(0)) {
+					Factorize(design, "least_squares_cod", cod_);
+				} else {
+					cod_.compute(design);
+				}
+				rank_ = static_cast<size_t>(cod_.rank());
+				break;
+			}
+		}
+
+		/// <summary>
+		/// 	<para> Factorize the design matrix, or copy the factorization of an equal design matrix from
+		/// 	the result cache, e.g. of identically spaced windows, see <c>ResultCache</c>. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		template<typename _Design, typename _Solver>
+		static void Factorize(const _Design& design, const char* key, _Solver& solver) {
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			if (ResultCache::Enabled()) {
+				const size_t bytes = static_cast<size_t>(design.size()) * sizeof(_T);
+				const _result_key content = { &typeid(_Design), design.data(), bytes, static_cast<size_t>(design.rows()),
+											  static_cast<size_t>(design.cols()), _content_hash(design.data(), bytes) };
+				const bool found = _result_cache::Instance().Find(content, key, 0, solver);
+				NUDTTK_INSTRUMENT_CACHE("result_cache", found);
+				if (!found) {
+					solver.compute(design);
+					_result_cache::Instance().Store(content, key, 0, solver, bytes);
+				}
+				return;
+			}
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+			solver.compute(design);
+		}
+
+		template<typename _Rhs, typename _Solution>
+		void SolveInto(const _Rhs& b, _Solution& x) const {
+			switch (method_) {
+			case QR:
+				x = qr_.solve(b);
+				break;
+			case ColPivQR:
+				x = col_piv_qr_.solve(b);
+				break;
+			case COD:
+				x = cod_.solve(b);
+				break;
+			}
+		}
+
+		Method method_;
+		size_t rows_, cols_, rank_;
+		// Only the factorization of the method is computed
+		Eigen::HouseholderQR<dense_type> qr_;
+		Eigen::ColPivHouseholderQR<dense_type> col_piv_qr_;
+		Eigen::CompleteOrthogonalDecomposition<dense_type> cod_;
+	};
+}
+
+#endif	// !_NUDTTK_MATH_LEAST_SQUARES_TR_
@@ -9,10 +9,17 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <limits>
 
 #include "matrix.h"
+#include "vector.h"
+#include "diagonal_matrix.h"
+#include "least_squares.h"
+#include "instrumentation.h"
 
 #if __cplusplus >= 201103L
+#include "statistics.h"
+
 #include <memory>
 #include <numeric>
 #include <random>
@@ -126,6 +133,7 @@ namespace NUDTTK {
 		/// <param name="ascend">    True to ascend. </param>
 		template<typename _T>
 		_CONSTEXPR_FN void Sort(_T sort_list[], const size_t list_size, const bool ascend = true) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::Sort");
 			if (ascend) {
 				// ASC
 				std::sort(sort_list, sort_list + list_size, std::less<_T>());
@@ -147,6 +155,7 @@ namespace NUDTTK {
 		/// <param name="ascend">		   True to ascend. </param>
 		template<typename _T>
 		_CONSTEXPR_FN void Sort(_T sort_list[], size_t sort_index_list[], const size_t list_size, const bool ascend = true) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::Sort");
 			// Initialize original index locations
 #if __cplusplus >= 201103L
 			std::iota(sort_index_list, sort_index_list + list_size, 0);
@@ -200,6 +209,7 @@ namespace NUDTTK {
 		/// <param name="n"> Order, n>=2. </param>
 		/// <param name="u"> sin(fai), [-1,1]. </param>
 		void LegendreFunc(long double** P, const size_t n, const double u) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::LegendreFunc");
 			const double cosu = std::sqrt(1 - u * u);
 			for (size_t i = 0; i <= n; i++) {
 				memset(P[i], 0, sizeof(long double) * (n + 1));
@@ -235,6 +245,7 @@ namespace NUDTTK {
 		/// <param name="n">  Order, n>=2. </param>
 		/// <param name="u">  sin(fai), [-1,1]. </param>
 		void LegendreFuncDerivative(long double** P, long double** DP, const size_t n, const double u) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::LegendreFuncDerivative");
 			// First calculate the Legendre function value P
 			LegendreFunc(P, n, u);
 			// Recursively calculate the derivative value of Legendre function DP
@@ -295,7 +306,8 @@ namespace NUDTTK {
 		/// <param name="x">  Interpolation point abscissa. </param>
 		/// <param name="y">  [in,out] Interpolation point ordinate. </param>
 		/// <param name="dy"> [in,out] Interpolation point speed. </param>
-		_CONSTEXPR_FN_A void InterploationLagrange(double xa[], double ya[], const size_t n, const double x, double& y, double& dy) _NOEXCEPT {
+		_CONSTEXPR_FN_I void InterploationLagrange(double xa[], double ya[], const size_t n, const double x, double& y, double& dy) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::InterploationLagrange");
 			// Determine if the interpolation point falls on a known point
 			int nFlag = -1;
 			for (size_t k = 0; k < n; k++) {
@@ -373,7 +385,7 @@ namespace NUDTTK {
 		/// <param name="n">  Number of known points, order n-1. </param>
 		/// <param name="x">  Interpolation point abscissa. </param>
 		/// <param name="y">  [in,out] Interpolation point ordinate. </param>
-		_CONSTEXPR_FN_A void InterploationLagrange(double xa[], double ya[], const size_t n, const double x, double& y) _NOEXCEPT {
+		_CONSTEXPR_FN_I void InterploationLagrange(double xa[], double ya[], const size_t n, const double x, double& y) _NOEXCEPT {
 			double dy = 0;
 			InterploationLagrange(xa, ya, n, x, y, dy);
 		}
@@ -390,6 +402,7 @@ namespace NUDTTK {
 		/// <returns> The median value. </returns>
 		template<typename _T>
 		_CONSTEXPR_FN _T Median(_T element_list[], const size_t list_size) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::Median");
 			if (list_size & 1) {
 				// Odd number [O(n)]
 				std::nth_element(element_list, element_list + list_size / 2, element_list + list_size);
@@ -416,6 +429,7 @@ namespace NUDTTK {
 		/// <returns> The sMAD value. </returns>
 		template<typename _T>
 		_CONSTEXPR_FN double Mad(const _T observation_list[], const size_t list_size) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::Mad");
 			std::vector<_T> list(observation_list, observation_list + list_size);
 #if __cplusplus >= 201103L
 			std::for_each(list.begin(), list.end(), [&](_T& value) {value = std::abs(value); });
@@ -440,26 +454,28 @@ namespace NUDTTK {
 		/// <param name="m">	 (Optional) Polynomial order, 2 = <m <= n, default is 3. </param>
 		/// <returns> True if it succeeds, false if it fails. </returns>
 		bool PolyFit(double x[], double y[], const size_t n, double y_fit[], const size_t m = 3) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::PolyFit");
 			if (m < 1 || m > n)
 				return false;
 
-			Matrix matC(n, m);
-			Matrix matY(n, 1);
-			std::vector<double> base(n, 0);
-
-			for (size_t i = 0; i < n; i++)
-				base[i] = x[i] - x[0];
-
-			for (size_t i = 0; i < n; i++) {
-				matY(i, 0) = y[i];
-				matC(i, 0) = 1.0;
-				for (size_t j = 1; j < m; j++)
-					matC(i, j) = std::pow(base[i], j);
+			// Rows of the transposed design matrix are the powers of the base, each one is the
+			// previous row scaled in place instead of std::pow per element
+			std::vector<double> powers(n * m, 1.0);
+			for (size_t j = 1; j < m; j++) {
+				for (size_t i = 0; i < n; i++)
+					powers[j * n + i] = powers[(j - 1) * n + i] * (x[i] - x[0]);
 			}
-			Matrix matS = Matrix(matC.Transpose() * matC).Inv() * matC.Transpose() * matY;
-			Matrix matY_Fit = matC * matS;
-			for (size_t i = 0; i < n; i++)
-				y_fit[i] = matY_Fit(i, 0);
+			Matrix matCT(m, n, powers.data());
+
+			// QR of the design matrix instead of inverting C^T C, which squares its condition number,
+			// the powers are the design matrix column by column
+			const LeastSquares<> solver(powers.data(), n, m, LeastSquares<>::QR);
+			if (!solver.IsFullRank())
+				return false;
+			// Observations and fitted values stay in the arrays
+			Vector vecS(m);
+			solver.Solve(y, vecS.Data());
+			Vector<>::Multiply(y_fit, matCT, vecS.Data(), 1.0, 0.0, true);
 
 			return true;
 		}
@@ -478,6 +494,7 @@ namespace NUDTTK {
 		/// <returns> True if it succeeds, false if it fails. </returns>
 		bool VandrakFilter(double x[], double y[], double w[],
 						   const size_t n, const double eps_v, double y_fit[]) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::VandrakFilter");
 			// Vandrak fitting requires at least 4 data
 			if (n < 4)
 				return false;
@@ -517,53 +534,55 @@ namespace NUDTTK {
 			  |*  *  *  0  1  2  3|
 			*/
 
-			for (size_t j = 0; j < n; j++) {
+			// Signed indices, the band loops below walk across the 0 and n - 4 boundaries
+			const int size = static_cast<int>(n);
+			for (int j = 0; j < size; j++) {
 				matA(3, j) = w[j] * eps;
-				for (size_t i = j; i >= j - 3; i--) {
+				for (int i = j; i >= j - 3; i--) {
 					int nCount = j - i;
-					if (i >= 0 && i <= n - 4) {
+					if (i >= 0 && i <= size - 4) {
 						// Make sure [0, n-4]
 						matA(3, j ) = matA(3, j) + std::pow(matABCD(nCount, i), 2);
 					}
 				}
 				// A_1j--> matA(4,:)
-				for (size_t i = j; i >= j - 2; i--) {
+				for (int i = j; i >= j - 2; i--) {
 					int nCount = j - i;
-					if (i >= 0 && i <= n - 4) {
+					if (i >= 0 && i <= size - 4) {
 						// Make sure [0, n-4]
 						matA(4, j + 1) = matA(4, j + 1) + matABCD(nCount, i) * matABCD(nCount + 1, i);
 					}
 				}
 				// A_2j--> matA(5,:)
-				for (size_t i = j; i >= j - 1; i--) {
+				for (int i = j; i >= j - 1; i--) {
 					int nCount = j - i;
-					if (i >= 0 && i <= n - 4) {
+					if (i >= 0 && i <= size - 4) {
 						// Make sure [0, n-4]
 						matA(5, j + 2) = matA(5, j + 2) + matABCD(nCount, i) * matABCD(nCount + 2, i);
 					}
 				}
 				// A_3j--> matA(6,:)
-				if (j <= n - 4) {
+				if (j <= size - 4) {
 					matA(6, j + 3) = matABCD(0, j) * matABCD(3, j);
 				}
 				// A_-1j--> matA(2,:)
-				for (size_t i = j - 1; i >= j - 3; i--) {
+				for (int i = j - 1; i >= j - 3; i--) {
 					int nCount = j - 1 - i;
-					if (i >= 0 && i <= n - 4) {
+					if (i >= 0 && i <= size - 4) {
 						// Make sure [0, n-4]
 						matA(2, j - 1) = matA(2, j - 1) + matABCD(nCount, i) * matABCD(nCount + 1, i);
 					}
 				}
 				// A_-2j--> matA(1,:)
-				for (size_t i = j - 2; i >= j - 3; i--) {
+				for (int i = j - 2; i >= j - 3; i--) {
 					int nCount = j - 2 - i;
-					if (i >= 0 && i <= n - 4) {
+					if (i >= 0 && i <= size - 4) {
 						// Make sure [0, n-4]
 						matA(1, j - 2) = matA(1, j - 2) + matABCD(nCount, i) * matABCD(nCount + 2, i);
 					}
 				}
 				// A_-3j--> matA(0,:)
-				if (j - 3 >= 0 && j - 3 <= n - 4) {
+				if (j - 3 >= 0 && j - 3 <= size - 4) {
 					//matA.SetElement(j,j-3,matABCD(0,j-3)*matABCD(3,j-3));
 					matA(0, j - 3) = matABCD(0, j - 3) * matABCD(3, j - 3);
 				}
@@ -575,10 +594,10 @@ namespace NUDTTK {
 				// Unitize by diagonal elements
 				double element_ii = matA(3, i);
 				matY(i, 0) = matY(i, 0) / element_ii;
-				for (size_t k = i; k < n; k++) {
-					if (3 - (i - k) <= 6) {
-						matA(3 - (i - k), k) = matA(3 - (i - k), k) / element_ii;
-					}
+				// Only the band columns [i, i + 3] are non-zero
+				const size_t K = (i + 3 < n - 1) ? i + 3 : n - 1;
+				for (size_t k = i; k <= K; k++) {
+					matA(3 + k - i, k) = matA(3 + k - i, k) / element_ii;
 				}
 
 				size_t N = (i + 3 < n - 1) ? i + 3 : n - 1;
@@ -586,10 +605,8 @@ namespace NUDTTK {
 					// Elimination is performed line by line, with a maximum of 3 lines
 					double element_ji = matA(3 - (j - i), i);
 					matY(j, 0) = matY(j, 0) - element_ji * matY(i, 0);
-					for (size_t k = i; k < n; k++) {
-						if (3 - (i - k) <= 6) {
-							matA(3 - (j - k), k) = matA(3 - (j - k), k) - element_ji * matA(3 - (i - k), k);
-						}
+					for (size_t k = i; k <= K; k++) {
+						matA(3 + k - j, k) = matA(3 + k - j, k) - element_ji * matA(3 + k - i, k);
 					}
 				}
 			}
@@ -630,6 +647,7 @@ namespace NUDTTK {
 										  const size_t n, double eps, double y_fit[],
 										  const double threshold_max, const double threshold_min,
 										  const size_t nwidth, const double factor = 3) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::KinematicRobustVandrakFilter");
 			bool bResult = true;
 #if __cplusplus >= 201103L
 			std::unique_ptr<double[]> error_fit(new double[n]());
@@ -748,6 +766,7 @@ namespace NUDTTK {
 		/// <param name="factor"> (Optional) Robust control factor, default 6. </param>
 		/// <returns> Robust estimation. </returns>
 		double RobustStatRms(double x[], double marker[], const size_t n, const double factor = 6.0) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::RobustStatRms");
 			double dVar = 0.0;
 			for (size_t i = 0; i < n; i++) {
 				marker[i] = 0.0;			// All points are considered normal at the initial moment
@@ -817,17 +836,25 @@ namespace NUDTTK {
 		/// <returns> True if it succeeds, false if it fails. </returns>
 		bool RobustStatMean(double x[], double w[], const size_t n,
 							double& dMean, double& dVar, const double factor = 6.0) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::RobustStatMean");
+			// All points are considered normal at the initial moment
+			std::fill(w, w + n, 0.0);
+#if __cplusplus >= 201103L
+			// Mean and variance in a single pass, a single value keeps the NaN of dividing by n - 1 = 0
+			const Statistics<double> stat = Reduce(x, n, Stat::Mean | Stat::Variance);
+			dMean = stat.mean;
+			dVar = n == 1 ? std::numeric_limits<double>::quiet_NaN() : std::sqrt(stat.variance);
+#else	// __cplusplus < 201103L
 			dMean = 0;
-			for (size_t i = 0; i < n; i++) {
-				w[i] = 0;						// All points are considered normal at the initial moment
+			for (size_t i = 0; i < n; i++)
 				dMean += x[i];
-			}
 			dMean /= n;
 			// 计算方差
 			dVar = 0;
 			for (size_t i = 0; i < n; i++)
 				dVar += std::pow(x[i] - dMean, 2);
 			dVar = std::sqrt(dVar / (n - 1));
+#endif	// __cplusplus >= 201103L
 
 			_CONSTEXPR int nn_max = 10;			// Maximum number of iterations threshold
 			int nn = 0;
@@ -899,6 +926,7 @@ namespace NUDTTK {
 		/// <returns> True if it succeeds, false if it fails. </returns>
 		bool RobustPolyFit(double x[], double y[], double w[],
 						   const size_t n, double y_fit[], const size_t m = 3) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::RobustPolyFit");
 #if __cplusplus >= 201103L
 			std::unique_ptr<double[]> w_new(new double[n]());
 #else	//__cplusplus < 201103L
@@ -913,32 +941,47 @@ namespace NUDTTK {
 				return false;
 			}
 
+			// 设计矩阵不随权重变化，按列存储 x 的各次幂，由递推代替逐元素 pow
+			std::vector<double> powers(n * m, 1.0);
+			for (size_t j = 1; j < m; j++) {
+				for (size_t i = 0; i < n; i++)
+					powers[j * n + i] = powers[(j - 1) * n + i] * (x[i] - x[0]);
+			}
+			const Matrix matCT(m, n, powers.data());
+
+			// 权重为 0 或 1，以 QR 求解保留点的最小二乘，剔除点不参与分解
+			std::vector<double> design(n * m), observation(n);
+			Vector vecS(m);
 			int nLoop = 0;
 			_CONSTEXPR int nLoop_max = 6; // 设置一个迭代次数阈值，避免迭代在临界处震荡，无法收敛
 			while (true) {
 				nLoop++;
-				Matrix matC(n, m);
-				Matrix matY(n, 1);
-#if __cplusplus >= 201103L
-				std::unique_ptr<double[]> xx(new double[n]());
-#else	//__cplusplus < 201103L
-				boost::scoped_array<double> xx(new double[n]());
-#endif  // __cplusplus >= 201103L
-				for (size_t i = 0; i < n; i++)
-					xx[i] = x[i] - x[0];
+				size_t k = 0;
 				for (size_t i = 0; i < n; i++) {
-					matY(i, 0) = w[i] * y[i];
-					matC(i, 0) = w[i] * 1.0;
-					for (size_t j = 1; j < m; j++)
-						matC(i, j) = w[i] * pow(xx[i], j);
+					if (w[i] != 0)
+						observation[k++] = y[i];
+				}
+				for (size_t j = 0; j < m; j++) {
+					double* column = design.data() + j * k;
+					for (size_t i = 0; i < n; i++) {
+						if (w[i] != 0)
+							*column++ = powers[j * n + i];
+					}
 				}
-				Matrix matS = Matrix(matC.Transpose() * matC).Inv() * matC.Transpose() * matY;
-				Matrix matY_Fit = matC * matS;
+				if (k < m)
+					return false;
+				const LeastSquares<> solver(design.data(), k, m, LeastSquares<>::QR);
+				if (!solver.IsFullRank())
+					return false;
+				solver.Solve(observation.data(), vecS.Data());
+				Vector<>::Multiply(y_fit, matCT, vecS.Data(), 1.0, 0.0, true);
+				// 剔除点的拟合值为 0
+				for (size_t i = 0; i < n; i++)
+					y_fit[i] *= w[i];
 				// 计算均方根
 				double rms = 0;
 				int kk = 0;
 				for (size_t i = 0; i < n; i++) {
-					y_fit[i] = matY_Fit(i, 0);
 					if (w[i] == 1.0) {
 						kk++;
 						rms += std::pow(y[i] - y_fit[i], 2);
@@ -968,6 +1011,7 @@ namespace NUDTTK {
 		/// <param name="sigma"> (Optional) The variance, default is 1.0. </param>
 		/// <returns> A double. </returns>
 		double RandNormal(const double mu = 0.0, const double sigma = 1.0) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Math::RandNormal");
 #if __cplusplus >= 201103L
 			std::mt19937 generator;
 			std::normal_distribution distribution(mu, std::sqrt(sigma));
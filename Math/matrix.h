@@ -4,8 +4,12 @@
 #define _NUDTTK_MATH_MATRIX_TR_
 
 #include "common.h"
+#include "instrumentation.h"
+#include "parallel.h"
+#include "result_cache.h"
 
 #include <map>
+#include <limits>
 #include <string>
 #include <sstream>
 
@@ -50,6 +54,9 @@
 #include <functional>
 #include <type_traits>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #if __cplusplus >= 201703L
 #include <any>
 #include <optional>
@@ -60,6 +67,8 @@
 #else	// __cplusplus < 201103L
 #define NOT_SUPPORT_LAZY_EVALUATION	// Not support lazy evaluation
 #include <boost/type_traits.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 #endif	// __cplusplus >= 201103L
 
 namespace NUDTTK {
@@ -70,22 +79,48 @@ namespace NUDTTK {
 	template<typename _T>
 	struct _non_scalar_support {};
 
-	template<typename _T>
+	template<typename _T = double, int _Layout = Eigen::RowMajor>
 	class Matrix;
 
-	/// <summary> A macro that defines modern (above C++11) unwrap binary operation. </summary>
+	template<typename _T>
+	class DiagonalMatrix;
+
+	template<typename _T>
+	class NormalEquation;
+
+	template<typename _T, int _Size>
+	class Vector;
+
+	// Element-wise nodes, see elementwise.h
+	template<typename _Operand, typename _Function>
+	class unary_op_impl;
+
+	template<typename _Lhs, typename _Rhs>
+	class cwise_mul_op_impl;
+
+	template<typename _Lhs, typename _Rhs>
+	class cwise_div_op_impl;
+
+	/// <summary>
+	/// 	<para> A macro that defines modern (above C++11) unwrap binary operation. </para>
+	/// 	<para> Evaluated by <c>_impl##_evaluate</c>, which reuses a temporary operand as the result. </para>
+	/// </summary>
 	/// <remarks> Blue Wing, 2020/3/14. </remarks>
+	/// <param name="_impl">	 The implement. </param>
 	/// <param name="_operator"> The operator. </param>
-#define BINARY_OP_UNWRAP_MODERN(_operator)										\
+#define BINARY_OP_UNWRAP_MODERN(_impl, _operator)								\
 public: template<typename _Result>												\
 _CONSTEXPR_FN _Result unwrap() const _NOEXCEPT {								\
-	return lhs_.unwrap<_Result>() _operator rhs_.unwrap<_Result>();				\
+	return _impl##_evaluate<_Result>::apply(									\
+		lhs_.template unwrap<typename _operand_result<_Lhs, _Result>::type>(),	\
+		rhs_.template unwrap<typename _operand_result<_Rhs, _Result>::type>());	\
 }
 
 /// <summary> A macro that defines legacy (below C++11) unwrap binary operation. </summary>
 /// <remarks> Blue Wing, 2020/3/14. </remarks>
+/// <param name="_impl">	 The implement, unused. </param>
 /// <param name="_operator"> The operator. </param>
-#define BINARY_OP_UNWRAP_LEGACY(_operator)										\
+#define BINARY_OP_UNWRAP_LEGACY(_impl, _operator)								\
 public: template<typename _Result>												\
 typename _Result unwrap() const {												\
 	return lhs_.unwrap<_Result>() _operator rhs_.unwrap<_Result>();				\
@@ -125,10 +160,12 @@ public:																			\
 	_CONSTEXPR_FN _impl##(_Lhs const& lhs, _Rhs const& rhs) _NOEXCEPT			\
 		: lhs_(lhs), rhs_(rhs) {}												\
 	BINARY_OP_UNUSED_CONSTRUCTOR(_impl)											\
-	BINARY_OP_UNWRAP(_operator)													\
+	BINARY_OP_UNWRAP(_impl, _operator)											\
+	_CONSTEXPR_FN const _Lhs& lhs() const _NOEXCEPT { return lhs_; }			\
+	_CONSTEXPR_FN const _Rhs& rhs() const _NOEXCEPT { return rhs_; }			\
 private:																		\
-	const _Lhs& lhs_;															\
-	const _Rhs& rhs_;															\
+	typename _operand_holder<_Lhs>::type lhs_;									\
+	typename _operand_holder<_Rhs>::type rhs_;									\
 };
 
 /// <summary> A macro that defines combine Implementation with binary Operation. </summary>
@@ -139,12 +176,12 @@ private:																		\
 /// <param name="_wrapped">  The wrapped. </param>
 #ifdef _TYPE_TRAITS_
 #define COMBINE_IMPL_WITH_BINARY_OP(_impl, _operator, _scalar_left, _scalar_right)				\
-template<typename _Scalar, typename _T,															\
+template<typename _Scalar, typename _T, int _Layout,															\
 	typename std::enable_if<std::is_arithmetic<_Scalar>::value									\
 	&& std::is_same<_scalar_support<_Scalar>, _scalar_left##<_Scalar>>::value, int>::type = 0>	\
-	_CONSTEXPR_FN _impl##<##_scalar_left##<_Scalar>, Matrix<_T>>								\
-	operator _operator##(const _Scalar& lhs, const Matrix<_T>& rhs) {							\
-	return _impl##<##_scalar_left##<_Scalar>, Matrix<_T>>(lhs, rhs);							\
+	_CONSTEXPR_FN _impl##<##_scalar_left##<_Scalar>, Matrix<_T, _Layout>>								\
+	operator _operator##(const _Scalar& lhs, const Matrix<_T, _Layout>& rhs) {							\
+	return _impl##<##_scalar_left##<_Scalar>, Matrix<_T, _Layout>>(lhs, rhs);							\
 }																								\
 template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	template<typename _Lhs, typename _Rhs> typename _Impl,										\
@@ -154,12 +191,12 @@ template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	operator _operator##(const _Scalar& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
 	return _impl##<##_scalar_left##<_Scalar>, _Impl<_Lhs, _Rhs>>(lhs, rhs);						\
 }																								\
-template<typename _Scalar, typename _T,															\
+template<typename _Scalar, typename _T, int _Layout,															\
 	typename std::enable_if<std::is_arithmetic<_Scalar>::value									\
 	&& std::is_same<_scalar_support<_Scalar>, _scalar_right##<_Scalar>>::value, int>::type = 0>	\
-	_CONSTEXPR_FN _impl##<Matrix<_T>, _scalar_right##<_Scalar>>									\
-	operator _operator##(const Matrix<_T>& lhs, const _Scalar& rhs) {							\
-	return _impl##<Matrix<_T>, _scalar_right##<_Scalar>>(lhs, rhs);								\
+	_CONSTEXPR_FN _impl##<Matrix<_T, _Layout>, _scalar_right##<_Scalar>>									\
+	operator _operator##(const Matrix<_T, _Layout>& lhs, const _Scalar& rhs) {							\
+	return _impl##<Matrix<_T, _Layout>, _scalar_right##<_Scalar>>(lhs, rhs);								\
 }																								\
 template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	template<typename _Lhs, typename _Rhs> typename _Impl,										\
@@ -169,22 +206,22 @@ template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const _Scalar& rhs) {					\
 	return _impl##<_Impl<_Lhs, _Rhs>, _scalar_right##<_Scalar>>(lhs, rhs);						\
 }																								\
-template<typename _T>																			\
-_CONSTEXPR_FN _impl##<Matrix<_T>, Matrix<_T>>													\
-	operator _operator##(const Matrix<_T>& lhs, const Matrix<_T>& rhs) {						\
-	return _impl##<Matrix<_T>, Matrix<_T>>(lhs, rhs);											\
+template<typename _T, int _Layout_l, int _Layout_r>											\
+_CONSTEXPR_FN _impl##<Matrix<_T, _Layout_l>, Matrix<_T, _Layout_r>>							\
+	operator _operator##(const Matrix<_T, _Layout_l>& lhs, const Matrix<_T, _Layout_r>& rhs) {	\
+	return _impl##<Matrix<_T, _Layout_l>, Matrix<_T, _Layout_r>>(lhs, rhs);					\
 }																								\
-template<typename _T, typename _Lhs, typename _Rhs,												\
+template<typename _T, int _Layout, typename _Lhs, typename _Rhs,												\
 	template<typename _Lhs, typename _Rhs> typename _Impl>										\
-_CONSTEXPR_FN _impl##<Matrix<_T>, _Impl<_Lhs, _Rhs>>											\
-	operator _operator##(const Matrix<_T>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
-	return _impl##<Matrix<_T>, _Impl<_Lhs, _Rhs>>(lhs, rhs);									\
+_CONSTEXPR_FN _impl##<Matrix<_T, _Layout>, _Impl<_Lhs, _Rhs>>											\
+	operator _operator##(const Matrix<_T, _Layout>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
+	return _impl##<Matrix<_T, _Layout>, _Impl<_Lhs, _Rhs>>(lhs, rhs);									\
 }																								\
-template<typename _T, typename _Lhs, typename _Rhs,												\
+template<typename _T, int _Layout, typename _Lhs, typename _Rhs,												\
 	template<typename _Lhs, typename _Rhs> typename _Impl>										\
-_CONSTEXPR_FN _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T>>											\
-	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const Matrix<_T>& rhs) {					\
-	return _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T>>(lhs, rhs);									\
+_CONSTEXPR_FN _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T, _Layout>>											\
+	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const Matrix<_T, _Layout>& rhs) {					\
+	return _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T, _Layout>>(lhs, rhs);									\
 }																								\
 template<typename _Lhs_l, typename _Rhs_l, typename _Lhs_r, typename _Rhs_r,					\
 	template<typename _Lhs_l, typename _Rhs_l> typename _Impl_l,								\
@@ -196,12 +233,12 @@ _CONSTEXPR_FN _impl##<_Impl_l<_Lhs_l, _Rhs_l>, _Impl_r<_Lhs_r, _Rhs_r>>							\
 }
 #else
 #define COMBINE_IMPL_WITH_BINARY_OP(_impl, _operator, _scalar_left, _scalar_right)				\
-template<typename _Scalar, typename _T,															\
+template<typename _Scalar, typename _T, int _Layout,															\
 	typename boost::enable_if_c<boost::is_arithmetic<_Scalar>::value							\
 	&& boost::is_same<_scalar_support<_Scalar>, _scalar_left##<_Scalar>>::value, int>::type = 0>\
-	_CONSTEXPR_FN _impl##<##_scalar_left##<_Scalar>, Matrix<_T>>								\
-	operator _operator##(const _Scalar& lhs, const Matrix<_T>& rhs) {							\
-	return _impl##<##_scalar_left##<_Scalar>, Matrix<_T>>(lhs, rhs);							\
+	_CONSTEXPR_FN _impl##<##_scalar_left##<_Scalar>, Matrix<_T, _Layout>>								\
+	operator _operator##(const _Scalar& lhs, const Matrix<_T, _Layout>& rhs) {							\
+	return _impl##<##_scalar_left##<_Scalar>, Matrix<_T, _Layout>>(lhs, rhs);							\
 }																								\
 template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	template<typename _Lhs, typename _Rhs> typename _Impl,										\
@@ -211,12 +248,12 @@ template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	operator _operator##(const _Scalar& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
 	return _impl##<##_scalar_left##<_Scalar>, _Impl<_Lhs, _Rhs>>(lhs, rhs);						\
 }																								\
-template<typename _Scalar, typename _T,															\
+template<typename _Scalar, typename _T, int _Layout,															\
 	typename boost::enable_if_c<boost::is_arithmetic<_Scalar>::value							\
 	&& boost::is_same<_scalar_support<_Scalar>, _scalar_right##<_Scalar>>::value, int>::type = 0>\
-	_CONSTEXPR_FN _impl##<Matrix<_T>, _scalar_right##<_Scalar>>									\
-	operator _operator##(const Matrix<_T>& lhs, const _Scalar& rhs) {							\
-	return _impl##<Matrix<_T>, _scalar_right##<_Scalar>>(lhs, rhs);								\
+	_CONSTEXPR_FN _impl##<Matrix<_T, _Layout>, _scalar_right##<_Scalar>>									\
+	operator _operator##(const Matrix<_T, _Layout>& lhs, const _Scalar& rhs) {							\
+	return _impl##<Matrix<_T, _Layout>, _scalar_right##<_Scalar>>(lhs, rhs);								\
 }																								\
 template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	template<typename _Lhs, typename _Rhs> typename _Impl,										\
@@ -226,22 +263,22 @@ template<typename _Scalar, typename _Lhs, typename _Rhs,										\
 	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const _Scalar& rhs) {					\
 	return _impl##<_Impl<_Lhs, _Rhs>, _scalar_right##<_Scalar>>(lhs, rhs);						\
 }																								\
-template<typename _T>																			\
-_CONSTEXPR_FN _impl##<Matrix<_T>, Matrix<_T>>													\
-	operator _operator##(const Matrix<_T>& lhs, const Matrix<_T>& rhs) {						\
-	return _impl##<Matrix<_T>, Matrix<_T>>(lhs, rhs);											\
+template<typename _T, int _Layout_l, int _Layout_r>											\
+_CONSTEXPR_FN _impl##<Matrix<_T, _Layout_l>, Matrix<_T, _Layout_r>>							\
+	operator _operator##(const Matrix<_T, _Layout_l>& lhs, const Matrix<_T, _Layout_r>& rhs) {	\
+	return _impl##<Matrix<_T, _Layout_l>, Matrix<_T, _Layout_r>>(lhs, rhs);					\
 }																								\
-template<typename _T, typename _Lhs, typename _Rhs,												\
+template<typename _T, int _Layout, typename _Lhs, typename _Rhs,												\
 	template<typename _Lhs, typename _Rhs> typename _Impl>										\
-_CONSTEXPR_FN _impl##<Matrix<_T>, _Impl<_Lhs, _Rhs>>											\
-	operator _operator##(const Matrix<_T>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
-	return _impl##<Matrix<_T>, _Impl<_Lhs, _Rhs>>(lhs, rhs);									\
+_CONSTEXPR_FN _impl##<Matrix<_T, _Layout>, _Impl<_Lhs, _Rhs>>											\
+	operator _operator##(const Matrix<_T, _Layout>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {					\
+	return _impl##<Matrix<_T, _Layout>, _Impl<_Lhs, _Rhs>>(lhs, rhs);									\
 }																								\
-template<typename _T, typename _Lhs, typename _Rhs,												\
+template<typename _T, int _Layout, typename _Lhs, typename _Rhs,												\
 	template<typename _Lhs, typename _Rhs> typename _Impl>										\
-_CONSTEXPR_FN _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T>>											\
-	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const Matrix<_T>& rhs) {					\
-	return _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T>>(lhs, rhs);									\
+_CONSTEXPR_FN _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T, _Layout>>											\
+	operator _operator##(const _Impl<_Lhs, _Rhs>& lhs, const Matrix<_T, _Layout>& rhs) {					\
+	return _impl##<_Impl<_Lhs, _Rhs>, Matrix<_T, _Layout>>(lhs, rhs);									\
 }																								\
 template<typename _Lhs_l, typename _Rhs_l, typename _Lhs_r, typename _Rhs_r,					\
 	template<typename _Lhs_l, typename _Rhs_l> typename _Impl_l,								\
@@ -272,31 +309,39 @@ COMBINE_IMPL_WITH_BINARY_OP(_impl, _operator, _scalar_support_left, _scalar_supp
 #define CLS_BINARY_OP(_class_name, _return_type, _variable_name, _impl)			\
 template<typename Lhs, typename Rhs>											\
 _CONSTEXPR_FN _class_name##(const _impl##<Lhs, Rhs>& op) _NOEXCEPT {			\
+	NUDTTK_INSTRUMENT_SCOPE(#_class_name "::" #_impl);							\
 	_variable_name = op.unwrap<##_return_type##>();								\
 }																				\
 template<typename Lhs, typename Rhs>											\
 _CONSTEXPR_FN _class_name##(_impl##<Lhs, Rhs>&& op) _NOEXCEPT {					\
+	NUDTTK_INSTRUMENT_SCOPE(#_class_name "::" #_impl);							\
 	_variable_name = std::move(op.unwrap<##_return_type##>());					\
 }																				\
 template<typename Lhs, typename Rhs>											\
 _CONSTEXPR_FN _class_name##& operator=(const _impl##<Lhs, Rhs>& op) _NOEXCEPT {	\
+	NUDTTK_INSTRUMENT_SCOPE(#_class_name "::" #_impl);							\
 	_variable_name = op.unwrap<##_return_type##>();								\
 	return *this;																\
 }																				\
 template<typename Lhs, typename Rhs>											\
 _CONSTEXPR_FN _class_name##& operator=(_impl##<Lhs, Rhs>&& op) _NOEXCEPT {		\
+	NUDTTK_INSTRUMENT_SCOPE(#_class_name "::" #_impl);							\
 	_variable_name = std::move(op.unwrap<##_return_type##>());					\
 	return *this;																\
 }
 
-/// <summary> A macro that defines class unwrap member binary operation. </summary>
+/// <summary>
+/// 	<para> A macro that defines class unwrap member binary operation. </para>
+/// 	<para> The value is returned as is whatever result type is evaluated, an operand of another
+/// 	storage order is converted by the expression evaluating it. </para>
+/// </summary>
 /// <remarks> Blue Wing, 2020/3/14. </remarks>
 /// <param name="_class_name">    Name of the class. </param>
 /// <param name="_return_type">   Type of the return. </param>
 /// <param name="_variable_name"> Name of the variable. </param>
 #define CLS_UNWRAP(_class_name, _return_type, _variable_name)					\
-template<typename _U = _return_type##>											\
-_CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
+template<typename _Unused = _return_type##>										\
+_CONSTEXPR_FN const _return_type& unwrap() const _NOEXCEPT {						\
 	return _variable_name##;													\
 }
 
@@ -314,26 +359,427 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		}
 	};
 
+	/// <summary>
+	/// 	<para> Operand holder of expression nodes. </para>
+	/// 	<para> Operands are referred, except scalars, which are converted to a temporary inside the
+	/// 	operator function and held by value. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand"> Type of the operand. </typeparam>
+	template<typename _Operand>
+	struct _operand_holder {
+		typedef const _Operand& type;
+	};
+
+	template<typename _T>
+	struct _operand_holder<_scalar_support<_T>> {
+		typedef const _scalar_support<_T> type;
+	};
+
+	/// <summary> Whether an expression operand evaluates into a column vector, see vector.h. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand"> Type of the operand. </typeparam>
+	template<typename _Operand>
+	struct _is_vector_operand {
+		static const bool value = false;
+	};
+
+	/// <summary>
+	/// 	<para> Type an expression operand is evaluated into for the result type. </para>
+	/// 	<para> A matrix operand of a vector result, e.g. <c>(A + B)</c> in <c>(A + B) * v</c>, keeps
+	/// 	its shape. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Operand"> Type of the operand. </typeparam>
+	/// <typeparam name="_Result">  Type of the result. </typeparam>
+	template<typename _Operand, typename _Result,
+		bool = (_Result::ColsAtCompileTime == 1 && !_is_vector_operand<_Operand>::value)>
+	struct _operand_result {
+		typedef _Result type;
+	};
+
+	template<typename _Operand, typename _Result>
+	struct _operand_result<_Operand, _Result, true> {
+		typedef Eigen::Matrix<typename _Result::Scalar, Eigen::Dynamic, Eigen::Dynamic> type;
+	};
+
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+	/// <summary>
+	/// 	<para> Evaluation of unwrapped operands of <c>add_op_impl</c>. </para>
+	/// 	<para> An operand evaluated into a temporary is updated in place and becomes the result, so a
+	/// 	chain like <c>a + b + c + d</c> allocates once. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct add_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs + rhs;
+		}
+		template<typename _Rhs>
+		static _Result apply(_Result&& lhs, const _Rhs& rhs) {
+			lhs += rhs;
+			return std::move(lhs);
+		}
+		template<typename _Lhs>
+		static _Result apply(const _Lhs& lhs, _Result&& rhs) {
+			rhs += lhs;
+			return std::move(rhs);
+		}
+		static _Result apply(_Result&& lhs, _Result&& rhs) {
+			lhs += rhs;
+			return std::move(lhs);
+		}
+	};
+
+	/// <summary> Evaluation of unwrapped operands of <c>sub_op_impl</c>, reuses a temporary operand. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct sub_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs - rhs;
+		}
+		template<typename _Rhs>
+		static _Result apply(_Result&& lhs, const _Rhs& rhs) {
+			lhs -= rhs;
+			return std::move(lhs);
+		}
+		template<typename _Lhs>
+		static _Result apply(const _Lhs& lhs, _Result&& rhs) {
+			// Coefficient-wise, safe when the destination is an operand
+			rhs = lhs - rhs;
+			return std::move(rhs);
+		}
+		static _Result apply(_Result&& lhs, _Result&& rhs) {
+			lhs -= rhs;
+			return std::move(lhs);
+		}
+	};
+
+	/// <summary>
+	/// 	<para> Evaluation of unwrapped operands of <c>mul_op_impl</c>. </para>
+	/// 	<para> Only scaling reuses a temporary operand, a matrix product always needs a new result. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct mul_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs * rhs;
+		}
+		static _Result apply(_Result&& lhs, const typename _Result::Scalar& rhs) {
+			lhs *= rhs;
+			return std::move(lhs);
+		}
+		static _Result apply(const typename _Result::Scalar& lhs, _Result&& rhs) {
+			rhs *= lhs;
+			return std::move(rhs);
+		}
+	};
+
+	/// <summary> Evaluation of unwrapped operands of <c>div_op_impl</c>, reuses a temporary dividend. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Result"> Type of the result. </typeparam>
+	template<typename _Result>
+	struct div_op_impl_evaluate {
+		template<typename _Lhs, typename _Rhs>
+		static _Result apply(const _Lhs& lhs, const _Rhs& rhs) {
+			return lhs / rhs;
+		}
+		static _Result apply(_Result&& lhs, const typename _Result::Scalar& rhs) {
+			lhs /= rhs;
+			return std::move(lhs);
+		}
+	};
+#endif	// !NOT_SUPPORT_LAZY_EVALUATION
+
 	// Support operator + - with Matrix, * for both Matrix and scalar
 	CREATE_AND_COMBINE_BINARY_OP(add_op_impl, +, _non_scalar_support, _non_scalar_support);
 	CREATE_AND_COMBINE_BINARY_OP(sub_op_impl, -, _non_scalar_support, _non_scalar_support);
 	CREATE_AND_COMBINE_BINARY_OP(mul_op_impl, *, _scalar_support, _scalar_support);
 	CREATE_AND_COMBINE_BINARY_OP(div_op_impl, / , _non_scalar_support, _scalar_support);
 
+	// A sum or a quotient has the shape of its left operand, a product the shape of its right one
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<add_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Lhs> {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<sub_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Lhs> {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<mul_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Rhs> {};
+	template<typename _Lhs, typename _Scalar>
+	struct _is_vector_operand<mul_op_impl<_Lhs, _scalar_support<_Scalar>>> : _is_vector_operand<_Lhs> {};
+	template<typename _Lhs, typename _Rhs>
+	struct _is_vector_operand<div_op_impl<_Lhs, _Rhs>> : _is_vector_operand<_Lhs> {};
+
 	// Epsilon value when check equality
 	_CONSTEXPR_FN double epsilon = 1e-7;
 
+	/// <summary>
+	/// 	<para> Reference counted copy-on-write storage of a value and its lazy evaluation cache. </para>
+	/// 	<para> Copies share the value and the cached results, so copying is O(1). Mutation detaches
+	/// 	a shared value by a deep copy and drops the cached results, a value owned exclusively is
+	/// 	modified in place. </para>
+	/// 	<para> Like <c>std::shared_ptr</c>, copies may be read and modified by different threads, but
+	/// 	one storage object MUST NOT be modified while other threads read or copy it. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Value"> Type of the value. </typeparam>
+	template<typename _Value>
+	class _shared_storage {
+	private:
+		struct _block {
+			explicit _block(const _Value& value) : value_(value) {}
+#if __cplusplus >= 201103L
+			explicit _block(_Value&& value) : value_(std::move(value)) {}
+#endif	// __cplusplus >= 201103L
+
+			_Value value_;
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			// Only locked by readers, a writer always owns the block exclusively
+			std::mutex mutex_;
+#ifdef _OPTIONAL_
+			std::map<std::string, std::any> lazy_value_map_;
+#else
+			std::map<std::string, boost::any> lazy_value_map_;
+#endif	// _OPTIONAL_
+#endif	// !NOT_SUPPORT_LAZY_EVALUATION
+		};
+
+#if __cplusplus >= 201103L
+		typedef std::shared_ptr<_block> pointer_type;
+#else
+		typedef boost::shared_ptr<_block> pointer_type;
+#endif	// __cplusplus >= 201103L
+
+	public:
+		/// <summary> Share the empty value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_shared_storage() _NOEXCEPT
+			: block_(Empty()) {}
+
+		/// <summary> Store a copy of the value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value. </param>
+		_shared_storage(const _Value& value)
+			: block_(MakeBlock(value)) {}
+
+#if __cplusplus >= 201103L
+		/// <summary> Store the value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value to be MOVED. </param>
+		_shared_storage(_Value&& value)
+			: block_(std::make_shared<_block>(std::move(value))) {}
+
+		_shared_storage(const _shared_storage& other) _NOEXCEPT = default;
+		_shared_storage& operator=(const _shared_storage& other) _NOEXCEPT = default;
+
+		/// <summary> Move constructor, the moved storage shares the empty value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other to be MOVED storage. </param>
+		_shared_storage(_shared_storage&& other) _NOEXCEPT
+			: block_(std::move(other.block_)) {
+			other.block_ = Empty();
+		}
+
+		/// <summary> Move assignment operator, swaps the values. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other to be MOVED storage. </param>
+		_shared_storage& operator=(_shared_storage&& other) _NOEXCEPT {
+			block_.swap(other.block_);
+			return *this;
+		}
+
+		/// <summary> Replace the value, reuses the memory when it is owned exclusively. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value to be MOVED. </param>
+		_shared_storage& operator=(_Value&& value) {
+			if (Exclusive()) {
+				block_->value_ = std::move(value);
+				ClearLazyValues();
+			} else {
+				block_ = std::make_shared<_block>(std::move(value));
+			}
+			return *this;
+		}
+#endif	// __cplusplus >= 201103L
+
+		/// <summary> Replace the value, reuses the memory when it is owned exclusively. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value. </param>
+		_shared_storage& operator=(const _Value& value) {
+			if (Exclusive()) {
+				block_->value_ = value;
+				ClearLazyValues();
+			} else {
+				block_ = MakeBlock(value);
+			}
+			return *this;
+		}
+
+		const _Value& operator*() const _NOEXCEPT {
+			return block_->value_;
+		}
+
+		const _Value* operator->() const _NOEXCEPT {
+			return &block_->value_;
+		}
+
+		operator const _Value&() const _NOEXCEPT {
+			return block_->value_;
+		}
+
+		/// <summary>
+		/// 	<para> Get the value for modification, a shared value is detached by a deep copy. </para>
+		/// 	<para> The cached results are dropped, the reference is invalidated by the next copy. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The value owned exclusively. </returns>
+		_Value& Mutable() {
+			if (Exclusive()) {
+				ClearLazyValues();
+			} else {
+				block_ = MakeBlock(block_->value_);
+			}
+			return block_->value_;
+		}
+
+		/// <summary>
+		/// 	<para> Get the value to be overwritten entirely, a shared value is replaced without copying. </para>
+		/// 	<para> The cached results are dropped, the content of a replaced value is unspecified. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The value owned exclusively. </returns>
+		_Value& Overwrite() {
+			if (Exclusive()) {
+				ClearLazyValues();
+			} else {
+				block_ = MakeBlock(_Value());
+			}
+			return block_->value_;
+		}
+
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+		/// <summary> Find a cached result. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <typeparam name="_Cached"> Type of the cached result. </typeparam>
+		/// <param name="key">    The cache entry name. </param>
+		/// <param name="cached"> [out] The cached result. </param>
+		/// <returns> True if the result is cached. </returns>
+		template<typename _Cached>
+		bool FindLazyValue(const std::string& key, _Cached& cached) const {
+			std::lock_guard<std::mutex> lock(block_->mutex_);
+			auto lazy_value = block_->lazy_value_map_.find(key);
+			if (lazy_value == block_->lazy_value_map_.end())
+				return false;
+#ifdef _OPTIONAL_
+			cached = std::any_cast<const _Cached&>(lazy_value->second);
+#else
+			cached = boost::any_cast<const _Cached&>(lazy_value->second);
+#endif	// _OPTIONAL_
+			return true;
+		}
+
+		/// <summary> Cache a result, shared by every copy of this value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <typeparam name="_Cached"> Type of the cached result. </typeparam>
+		/// <param name="key">    The cache entry name. </param>
+		/// <param name="cached"> The result. </param>
+		template<typename _Cached>
+		void StoreLazyValue(const std::string& key, const _Cached& cached) const {
+			std::lock_guard<std::mutex> lock(block_->mutex_);
+			block_->lazy_value_map_[key] = cached;
+		}
+
+		/// <summary> Drop a cached result, e.g. one depending on an assumption about the value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="key"> The cache entry name. </param>
+		void EraseLazyValue(const std::string& key) const {
+			std::lock_guard<std::mutex> lock(block_->mutex_);
+			block_->lazy_value_map_.erase(key);
+		}
+#endif	// !NOT_SUPPORT_LAZY_EVALUATION
+
+	private:
+		bool Exclusive() const _NOEXCEPT {
+			if (block_.use_count() != 1)
+				return false;
+#if __cplusplus >= 201103L
+			// The count is read relaxed, synchronize with the release of the last other copy, e.g. by an
+			// InvAsync task on another thread, before the value and the cached results are modified
+			std::atomic_thread_fence(std::memory_order_acquire);
+#endif	// __cplusplus >= 201103L
+			return true;
+		}
+
+		void ClearLazyValues() _NOEXCEPT {
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			// Owned exclusively, no other thread can reach the block
+			block_->lazy_value_map_.clear();
+#endif	// !NOT_SUPPORT_LAZY_EVALUATION
+		}
+
+		static pointer_type MakeBlock(const _Value& value) {
+#if __cplusplus >= 201103L
+			return std::make_shared<_block>(value);
+#else
+			return boost::make_shared<_block>(value);
+#endif	// __cplusplus >= 201103L
+		}
+
+		static const pointer_type& Empty() _NOEXCEPT {
+			// Never owned exclusively, so it is never modified
+			static const pointer_type empty = MakeBlock(_Value());
+			return empty;
+		}
+
+		pointer_type block_;
+	};
+
+	namespace Structure {
+		/// <summary>
+		/// 	<para> Structure of a square matrix that routes <c>Inv</c>, <c>DetGauss</c> and <c>Solve</c>
+		/// 	to a specialized algorithm, combined with <c>|</c>. </para>
+		/// 	<para> Detected by <c>Matrix::AnalyzeStructure</c>, or asserted by <c>Matrix::AssumeStructure</c>.
+		/// 	A symmetric matrix with a positive diagonal is factorized by Cholesky, which falls back to LU
+		/// 	if it is not positive definite after all. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		enum Flags {
+			General = 0x00,				// No structure, LU
+			Diagonal = 0x01,			// Zero off the diagonal
+			Lower = 0x02,				// Zero above the diagonal, triangular solve
+			Upper = 0x04,				// Zero below the diagonal, triangular solve
+			Banded = 0x08,				// Zero beyond a narrow bandwidth, banded Cholesky if symmetric
+			Symmetric = 0x10,			// Equal to the transpose, Cholesky on the lower triangle
+			PositiveDefinite = 0x20		// Symmetric positive definite, e.g. a normal matrix
+		};
+	}
+
 	/// <summary> A wrapper class for Eigen to support. </summary>
 	/// <remarks> Blue Wing, 2020/3/14. </remarks>
-	/// <typeparam name="_T"> Type of the t. </typeparam>
-	template<typename _T = double>
+	/// <typeparam name="_T">	   Type of the t. </typeparam>
+	/// <typeparam name="_Layout">
+	/// 	<para> Storage order, <c>Eigen::RowMajor</c> (default) or <c>Eigen::ColMajor</c>. </para>
+	/// 	<para> Column-major storage is native to LAPACK (MKL) and Eigen decompositions. Expressions
+	/// 	may mix layouts, they are evaluated into the destination layout without transposed copies. </para>
+	/// </typeparam>
+	template<typename _T, int _Layout>
 	class Matrix {
 	public:
-		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> base_type;
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic, _Layout> base_type;
+		// Matrix of the other storage order, whose storage is the transpose of the same storage
+		typedef Matrix<_T, _Layout == Eigen::RowMajor ? Eigen::ColMajor : Eigen::RowMajor> transpose_layout_type;
 		CLS_BINARY_OP(Matrix, base_type, value_, add_op_impl);
 		CLS_BINARY_OP(Matrix, base_type, value_, sub_op_impl);
 		CLS_BINARY_OP(Matrix, base_type, value_, mul_op_impl);
 		CLS_BINARY_OP(Matrix, base_type, value_, div_op_impl);
+		CLS_BINARY_OP(Matrix, base_type, value_, unary_op_impl);
+		CLS_BINARY_OP(Matrix, base_type, value_, cwise_mul_op_impl);
+		CLS_BINARY_OP(Matrix, base_type, value_, cwise_div_op_impl);
 		CLS_UNWRAP(Matrix, base_type, value_);
 
 	public:
@@ -346,7 +792,7 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="row_size"> Size of the row. </param>
 		/// <param name="col_size"> Size of the col. </param>
 		_CONSTEXPR_FN Matrix(const size_t row_size, const size_t col_size) _NOEXCEPT
-			: value_(base_type::Zero(row_size, col_size)) {}
+			: value_(base_type(base_type::Zero(row_size, col_size))) {}
 
 		/// <summary> Initialize Matrix in row size and col size with default values. </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
@@ -357,15 +803,16 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// 	<para> The caller MUST ensure that the size of the number is the same as the
 		/// 	parameter passed in, otherwise a serious problem of out-of-bounds memory reads and writes
 		/// 	will occur. </para>
+		/// 	<para> The values are given row by row in any storage order. </para>
 		/// </param>
 		_CONSTEXPR_FN Matrix(const size_t row_size, const size_t col_size, _T default_values[])
-			: value_(Eigen::Map<base_type>(default_values, row_size, col_size)) {}
+			: value_(base_type(Eigen::Map<row_major_type>(default_values, row_size, col_size))) {}
 
 		/// <summary> Initialize square Matrix in square size. </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
 		/// <param name="edge_size"> Edge size of the square. </param>
 		_CONSTEXPR_FN Matrix(const size_t edge_size) _NOEXCEPT
-			: value_(base_type::Zero(edge_size, edge_size)) {}
+			: value_(base_type(base_type::Zero(edge_size, edge_size))) {}
 
 		/// <summary> Initialize square Matrix in square size with default values. </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
@@ -375,19 +822,22 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// 	<para> The caller MUST ensure that the size of the number is the same as the
 		/// 	parameter passed in, otherwise a serious problem of out-of-bounds memory reads and writes
 		/// 	will occur. </para>
+		/// 	<para> The values are given row by row in any storage order. </para>
 		/// </param>
 		_CONSTEXPR_FN Matrix(const size_t edge_size, _T default_values[])
-			: value_(Eigen::Map<base_type>(default_values, edge_size, edge_size)) {}
+			: value_(base_type(Eigen::Map<row_major_type>(default_values, edge_size, edge_size))) {}
 
-		/// <summary> Copy constructor. </summary>
+		/// <summary> Copy constructor, shares the value and the cached results in O(1). </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
 		/// <param name="other"> Other Matrix instance. </param>
-		_CONSTEXPR_FN Matrix(const Matrix<_T>& other) _NOEXCEPT
-			: value_(other.value_)
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			, lazy_value_map_(other.lazy_value_map_)
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
-		{}
+		_CONSTEXPR_FN Matrix(const Matrix<_T, _Layout>& other) _NOEXCEPT
+			: value_(other.value_) {}
+
+		/// <summary> Copy constructor from the other storage order, the values are reordered. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Matrix instance. </param>
+		explicit Matrix(const transpose_layout_type& other)
+			: value_(base_type(*other.value_)) {}
 
 		/// <summary> Constructor. </summary>
 		/// <remarks> Blue Wing, 2020/3/22. </remarks>
@@ -404,7 +854,7 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <summary> Constructor. </summary>
 		/// <remarks> Blue Wing, 2020/3/22. </remarks>
 		/// <param name="value"> The value. </param>
-		_CONSTEXPR_FN Matrix<_T>& operator=(const base_type& value) _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator=(const base_type& value) _NOEXCEPT {
 			value_ = value;
 			return *this;
 		}
@@ -412,21 +862,17 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <summary> Constructor. </summary>
 		/// <remarks> Blue Wing, 2020/3/22. </remarks>
 		/// <param name="value"> The value. </param>
-		_CONSTEXPR_FN Matrix<_T>& operator=(base_type&& value) _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator=(base_type&& value) _NOEXCEPT {
 			value_ = std::move(value);
 			return *this;
 		}
 
-		/// <summary> Copy assignment operator. </summary>
+		/// <summary> Copy assignment operator, shares the value and the cached results in O(1). </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
 		/// <param name="other"> Other Matrix instance. </param>
 		/// <returns> A shallow copy of this. </returns>
-		_CONSTEXPR_FN Matrix<_T>& operator=(const Matrix<_T>& other) _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator=(const Matrix<_T, _Layout>& other) _NOEXCEPT {
 			value_ = other.value_;
-
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			lazy_value_map_ = other.lazy_value_map_;
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
 			return *this;
 		}
 
@@ -435,29 +881,137 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <summary> Move constructor. </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
 		/// <param name="other"> Other to be MOVED Matrix instance. </param>
-		_CONSTEXPR_FN Matrix(Matrix<_T>&& other) _NOEXCEPT
-			: value_(std::move(other.value_))
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			, lazy_value_map_(std::move(other.lazy_value_map_))
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
-		{}
+		_CONSTEXPR_FN Matrix(Matrix<_T, _Layout>&& other) _NOEXCEPT
+			: value_(std::move(other.value_)) {}
 
 		/// <summary> Move assignment operator. </summary>
 		/// <remarks> Blue Wing, 2020/3/15. </remarks>
 		/// <param name="other"> Other to be MOVED Matrix instance. </param>
 		/// <returns> A shallow copy of this. </returns>
-		_CONSTEXPR_FN Matrix<_T>& operator=(Matrix<_T>&& other) _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator=(Matrix<_T, _Layout>&& other) _NOEXCEPT {
 			value_ = std::move(other.value_);
-
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			lazy_value_map_ = std::move(other.lazy_value_map_);
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
 			return *this;
 		}
 #endif	// __cplusplus >= 201103L
 
 		~Matrix() _NOEXCEPT {}
 
+	public:
+		/// <summary> Add other matrix in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Matrix instance of any storage order, may be this. </param>
+		/// <returns> This. </returns>
+		template<int _OtherLayout>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator+=(const Matrix<_T, _OtherLayout>& other) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator+=");
+			// Coefficient-wise, safe when other is this
+			base_type& value = value_.Mutable();
+			value += *other.value_;
+			return *this;
+		}
+
+		/// <summary> Subtract other matrix in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Matrix instance of any storage order, may be this. </param>
+		/// <returns> This. </returns>
+		template<int _OtherLayout>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator-=(const Matrix<_T, _OtherLayout>& other) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator-=");
+			base_type& value = value_.Mutable();
+			value -= *other.value_;
+			return *this;
+		}
+
+		/// <summary> Multiply by other matrix from the right. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Matrix instance of any storage order, may be this. </param>
+		/// <returns> This. </returns>
+		template<int _OtherLayout>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator*=(const Matrix<_T, _OtherLayout>& other) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator*=");
+			// Eigen evaluates the product into a temporary as it may alias
+			base_type& value = value_.Mutable();
+			value *= *other.value_;
+			return *this;
+		}
+
+		/// <summary> Multiply by scalar in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="scalar"> The scalar. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator*=(const _T& scalar) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator*=");
+			value_.Mutable() *= scalar;
+			return *this;
+		}
+
+		/// <summary> Divide by scalar in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="scalar"> The scalar. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator/=(const _T& scalar) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator/=");
+			value_.Mutable() /= scalar;
+			return *this;
+		}
+
+		/// <summary> Add matrix product in place, without temporary unless an operand is this. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The product, e.g. <c>A.Transpose() * A</c>. </param>
+		/// <returns> This. </returns>
+		template<int _LayoutL, int _LayoutR>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator+=(const mul_op_impl<Matrix<_T, _LayoutL>, Matrix<_T, _LayoutR>>& op) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator+=");
+			return AccumulateProduct(op, false);
+		}
+
+		/// <summary> Subtract matrix product in place, without temporary unless an operand is this. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The product. </param>
+		/// <returns> This. </returns>
+		template<int _LayoutL, int _LayoutR>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator-=(const mul_op_impl<Matrix<_T, _LayoutL>, Matrix<_T, _LayoutR>>& op) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator-=");
+			return AccumulateProduct(op, true);
+		}
+
+		/// <summary> Add expression in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The expression, may refer to this. </param>
+		/// <returns> This. </returns>
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator+=(const _Impl<_Lhs, _Rhs>& op) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator+=");
+			// Evaluate before writing, the expression may refer to this
+			const base_type result = op.template unwrap<base_type>();
+			value_.Mutable() += result;
+			return *this;
+		}
+
+		/// <summary> Subtract expression in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The expression, may refer to this. </param>
+		/// <returns> This. </returns>
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator-=(const _Impl<_Lhs, _Rhs>& op) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator-=");
+			const base_type result = op.template unwrap<base_type>();
+			value_.Mutable() -= result;
+			return *this;
+		}
+
+		/// <summary> Multiply by expression from the right. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The expression, may refer to this. </param>
+		/// <returns> This. </returns>
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		_CONSTEXPR_FN Matrix<_T, _Layout>& operator*=(const _Impl<_Lhs, _Rhs>& op) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::operator*=");
+			const base_type result = op.template unwrap<base_type>();
+			value_.Mutable() *= result;
+			return *this;
+		}
+
 	public:
 		/// <summary>
 		/// 	<para> So called initializes. </para>
@@ -469,14 +1023,9 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="col_size"> Size of the col. </param>
 		/// <returns> Intentionally always return true. </returns>
 		_CONSTEXPR_FN bool Init(const size_t row_size, const size_t col_size) _NOEXCEPT {
-			// Move constructor
-			value_ = base_type::Zero(row_size, col_size);
-
-			// Should update lazy evaluation values
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			std::for_each(lazy_value_map_.begin(), lazy_value_map_.end(),
-						  [&](auto& lazy_value) {lazy_value.second.reset(); });
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Init");
+			// Move assignment, lazy evaluation values are dropped by the storage
+			value_ = base_type(base_type::Zero(row_size, col_size));
 
 			return true;
 		}
@@ -486,14 +1035,9 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="edge_size"> Size of the edge. </param>
 		/// <returns> Intentionally always return true. </returns>
 		_CONSTEXPR_FN bool MakeUnitMatrix(const size_t edge_size) _NOEXCEPT {
-			// Move constructor
-			value_ = base_type::Identity(edge_size, edge_size);
-
-			// Should update lazy evaluation values
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			std::for_each(lazy_value_map_.begin(), lazy_value_map_.end(),
-						  [&](auto& lazy_value) {lazy_value.second.reset(); });
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::MakeUnitMatrix");
+			// Move assignment, lazy evaluation values are dropped by the storage
+			value_ = base_type(base_type::Identity(edge_size, edge_size));
 
 			return true;
 		}
@@ -506,7 +1050,7 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		std::string ToString(const std::string& delim = " ", const bool line_break = true) _NOEXCEPT {
 			Eigen::IOFormat print_format(Eigen::FullPrecision, 0, delim, line_break ? "\n" : "");
 			std::stringstream ss;
-			ss << value_.format(print_format);
+			ss << value_->format(print_format);
 			return ss.str();
 		}
 
@@ -515,14 +1059,14 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <param name="other"> The other. </param>
 		/// <returns> True if the parameters are considered equivalent. </returns>
-		_CONSTEXPR_FN bool operator ==(const Matrix<_T>& other) const _NOEXCEPT {
-			if (other.value_.isZero()) {
+		_CONSTEXPR_FN bool operator ==(const Matrix<_T, _Layout>& other) const _NOEXCEPT {
+			if (other.value_->isZero()) {
 				// According to Eigen document, when other is Zero matrix, should use isMuchSmallerThan
 				// and given epsilon value
-				return value_.isMuchSmallerThan(other.value_, epsilon);
+				return value_->isMuchSmallerThan(*other.value_, epsilon);
 			} else {
 				// For matrices, the comparison is done using the Hilbert-Schmidt norm
-				return value_.isApprox(other.value_);
+				return value_->isApprox(*other.value_);
 			}
 		}
 
@@ -530,7 +1074,7 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <param name="other"> The other. </param>
 		/// <returns> True if the parameters are not considered equivalent. </returns>
-		_CONSTEXPR_FN bool operator !=(const Matrix<_T>& other) const _NOEXCEPT {
+		_CONSTEXPR_FN bool operator !=(const Matrix<_T, _Layout>& other) const _NOEXCEPT {
 			return !(*this == other);
 		}
 
@@ -541,14 +1085,8 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="value">	 The value. </param>
 		/// <returns> Intentionally always return true. </returns>
 		_CONSTEXPR_FN bool SetElement(const size_t row_index, const size_t col_index, _T value) _NOEXCEPT {
-			value_(row_index, col_index) = value;
-
-			// Should update lazy evaluation values
-#ifndef NOT_SUPPORT_LAZY_EVALUATION
-			std::for_each(lazy_value_map_.begin(), lazy_value_map_.end(),
-						  [&](auto& lazy_value) {lazy_value.second.reset(); });
-#endif // !NOT_SUPPORT_LAZY_EVALUATION
-
+			// Detach shared value and drop lazy evaluation values
+			value_.Mutable()(row_index, col_index) = value;
 			return true;
 		}
 
@@ -557,29 +1095,33 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="row_index"> Zero-based index of the row index. </param>
 		/// <param name="col_index"> Zero-based index of the col index. </param>
 		_CONSTEXPR_FN _T GetElement(const size_t row_index, const size_t col_index) const _NOEXCEPT {
-			return value_(row_index, col_index);
+			return (*value_)(row_index, col_index);
 		}
 
-		/// <summary> Function call operator. </summary>
+		/// <summary>
+		/// 	<para> Function call operator. </para>
+		/// 	<para> Detaches a shared value and drops lazy evaluation values, the reference is
+		/// 	invalidated by the next copy of this matrix. </para>
+		/// </summary>
 		/// <remarks> Blue Wing, 2020/4/14. </remarks>
 		/// <param name="row_index"> Zero-based index of the row. </param>
 		/// <param name="col_index"> Zero-based index of the col. </param>
 		_T& operator()(const size_t row_index, const size_t col_index) _NOEXCEPT {
-			return value_(row_index, col_index);
+			return value_.Mutable()(row_index, col_index);
 		}
 
 		/// <summary> Gets number columns. </summary>
 		/// <remarks> Blue Wing, 2020/3/16. </remarks>
 		/// <returns> The number columns. </returns>
 		_CONSTEXPR_FN size_t GetNumColumns() const _NOEXCEPT {
-			return static_cast<size_t>(value_.cols());
+			return static_cast<size_t>(value_->cols());
 		}
 
 		/// <summary> Gets number rows. </summary>
 		/// <remarks> Blue Wing, 2020/3/16. </remarks>
 		/// <returns> The number rows. </returns>
 		_CONSTEXPR_FN size_t GetNumRows() const _NOEXCEPT {
-			return static_cast<size_t>(value_.rows());
+			return static_cast<size_t>(value_->rows());
 		}
 
 		/// <summary> Get the max item and coordinates. </summary>
@@ -587,13 +1129,15 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="row_index"> [in,out] Zero-based index of the row. </param>
 		/// <param name="col_index"> [in,out] Zero-based index of the col. </param>
 		_CONSTEXPR_FN _T Max(size_t& row_index, size_t& col_index) const _NOEXCEPT {
-			return value_.maxCoeff(&row_index, &col_index);
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Max");
+			return value_->maxCoeff(&row_index, &col_index);
 		}
 
 		/// <summary> Get the max item. </summary>
 		/// <remarks> Blue Wing, 2020/3/16. </remarks>
 		_CONSTEXPR_FN _T Max() const _NOEXCEPT {
-			return value_.maxCoeff();
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Max");
+			return value_->maxCoeff();
 		}
 
 		/// <summary> Get the min item and coordinates. </summary>
@@ -601,68 +1145,108 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <param name="nRow"> [in,out] The row. </param>
 		/// <param name="nCol"> [in,out] The col. </param>
 		_CONSTEXPR_FN _T Min(size_t& row_index, size_t& col_index) const _NOEXCEPT {
-			return value_.minCoeff(&row_index, &col_index);
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Min");
+			return value_->minCoeff(&row_index, &col_index);
 		}
 
 		/// <summary> Get the min item. </summary>
 		/// <remarks> Blue Wing, 2020/3/16. </remarks>
 		_CONSTEXPR_FN _T Min() const _NOEXCEPT {
-			return value_.minCoeff();
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Min");
+			return value_->minCoeff();
 		}
 
 	public:
-		/// <summary> Gets the transpose. </summary>
+		/// <summary> Gets the transpose, a cached transpose is returned in O(1). </summary>
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <returns> A Matrix&lt;_T&gt; </returns>
-		_CONSTEXPR_FN Matrix<_T> Transpose() _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout> Transpose() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Transpose");
 #ifndef NOT_SUPPORT_LAZY_EVALUATION
-			auto& lazy_value = std::any_cast<value_t&>(lazy_value_map_.at("tranpose_value"));
-			if (!lazy_value) {
-				lazy_value = value_.transpose();
+			storage_t lazy_value;
+			const bool cached = value_.FindLazyValue("tranpose_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("tranpose_value", cached);
+			if (!cached) {
+				lazy_value = base_type(value_->transpose());
+				value_.StoreLazyValue("tranpose_value", lazy_value);
 			}
-			return Matrix<_T>(lazy_value.value());
+			return Matrix<_T, _Layout>(lazy_value);
 #else
-			return Matrix<_T>(value_.transpose());
+			return Matrix<_T, _Layout>(base_type(value_->transpose()));
 #endif // !NOT_SUPPORT_LAZY_EVALUATION
 		}
 
-		/// <summary> Gets the abs. </summary>
+		/// <summary>
+		/// 	<para> Gets the transpose in the other storage order, a cached one is returned in O(1). </para>
+		/// 	<para> The storage read in the other order is the transpose, so it is copied linearly
+		/// 	instead of being transposed with strides. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> A Matrix of the other storage order. </returns>
+		_CONSTEXPR_FN transpose_layout_type ReinterpretTranspose() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::ReinterpretTranspose");
+			typedef typename transpose_layout_type::base_type transpose_base_type;
+			const Eigen::Map<const transpose_base_type> reinterpreted(value_->data(), value_->cols(), value_->rows());
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			typename transpose_layout_type::storage_t lazy_value;
+			const bool cached = value_.FindLazyValue("layout_transpose_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("layout_transpose_value", cached);
+			if (!cached) {
+				lazy_value = transpose_base_type(reinterpreted);
+				value_.StoreLazyValue("layout_transpose_value", lazy_value);
+			}
+			return transpose_layout_type(lazy_value);
+#else
+			return transpose_layout_type(transpose_base_type(reinterpreted));
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+		}
+
+		/// <summary> Gets the abs, a cached abs is returned in O(1). </summary>
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <returns> A Matrix&lt;_T&gt; </returns>
-		_CONSTEXPR_FN Matrix<_T> Abs() _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout> Abs() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Abs");
 #ifndef NOT_SUPPORT_LAZY_EVALUATION
-			auto& lazy_value = std::any_cast<value_t&>(lazy_value_map_.at("absolute_value"));
-			if (!lazy_value) {
-				lazy_value = value_.cwiseAbs();
+			storage_t lazy_value;
+			const bool cached = value_.FindLazyValue("absolute_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("absolute_value", cached);
+			if (!cached) {
+				lazy_value = base_type(value_->cwiseAbs());
+				value_.StoreLazyValue("absolute_value", lazy_value);
 			}
-			return Matrix<_T>(lazy_value.value());
+			return Matrix<_T, _Layout>(lazy_value);
 #else
-			return Matrix<_T>(value_.cwiseAbs());
+			return Matrix<_T, _Layout>(base_type(value_->cwiseAbs()));
 #endif // !NOT_SUPPORT_LAZY_EVALUATION
 		}
 
-		/// <summary> Gets the inverse. </summary>
+		/// <summary> Gets the inverse, a cached inverse is returned in O(1). </summary>
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
-		/// <returns> A Matrix&lt;_T&gt; </returns>
-		_CONSTEXPR_FN Matrix<_T> Inv() _NOEXCEPT {
+		/// <returns> A Matrix&lt;_T&gt;, empty if this is singular </returns>
+		_CONSTEXPR_FN Matrix<_T, _Layout> Inv() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Inv");
 #ifndef NOT_SUPPORT_LAZY_EVALUATION
-			auto& lazy_value = std::any_cast<value_t&>(lazy_value_map_.at("inverse_value"));
-			if (!lazy_value) {
-				Eigen::FullPivLU<base_type> lu(value_);
-				if (lu.isInvertible()) {
-					lazy_value = value_.inverse();
-					return Matrix<_T>(lazy_value.value());
-				} else {
-					return Matrix<_T>();
+			storage_t lazy_value;
+			const bool cached = value_.FindLazyValue("inverse_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("inverse_value", cached);
+			if (!cached) {
+				const long variant = Routing().flags;
+				if (!FindSharedValue("inverse_value", variant, lazy_value)) {
+					base_type inverse;
+					if (!Invert(inverse))
+						return Matrix<_T, _Layout>();
+					lazy_value = inverse;
+					StoreSharedValue("inverse_value", variant, lazy_value, inverse.size() * sizeof(_T));
 				}
+				value_.StoreLazyValue("inverse_value", lazy_value);
 			}
-			return Matrix<_T>(lazy_value.value());
+			return Matrix<_T, _Layout>(lazy_value);
 #else
-			Eigen::FullPivLU<base_type> lu(value_);
-			if (lu.isInvertible()) {
-				return Matrix<_T>(value_.inverse());
+			base_type inverse;
+			if (Invert(inverse)) {
+				return Matrix<_T, _Layout>(inverse);
 			} else {
-				return Matrix<_T>();
+				return Matrix<_T, _Layout>();
 			}
 #endif // !NOT_SUPPORT_LAZY_EVALUATION
 		}
@@ -670,44 +1254,838 @@ _CONSTEXPR_FN _U unwrap() const _NOEXCEPT {										\
 		/// <summary> Inverse ssgj. </summary>
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <returns> A Matrix&lt;_T&gt; </returns>
-		_CONSTEXPR_FN Matrix<_T> Inv_Ssgj() const _NOEXCEPT {
+		_CONSTEXPR_FN Matrix<_T, _Layout> Inv_Ssgj() const _NOEXCEPT {
 			return Inv();
 		}
 
 		/// <summary> Get matrix determinant value. </summary>
 		/// <remarks> Blue Wing, 2020/3/21. </remarks>
 		/// <returns> Determinant value </returns>
-		_CONSTEXPR_FN _T DetGauss() _NOEXCEPT {
+		_CONSTEXPR_FN _T DetGauss() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::DetGauss");
 #ifndef NOT_SUPPORT_LAZY_EVALUATION
-			auto& lazy_value = std::any_cast<scalar_t&>(lazy_value_map_.at("determinant_value"));
-			if (!lazy_value) {
-				lazy_value = value_.determinant();
+			_T lazy_value = _T();
+			const bool cached = value_.FindLazyValue("determinant_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("determinant_value", cached);
+			if (!cached) {
+				const long variant = Routing().flags;
+				if (!FindSharedValue("determinant_value", variant, lazy_value)) {
+					lazy_value = Determinant();
+					StoreSharedValue("determinant_value", variant, lazy_value, sizeof(_T));
+				}
+				value_.StoreLazyValue("determinant_value", lazy_value);
 			}
-			return lazy_value.value();
+			return lazy_value;
 #else
-			return value_.determinant();
+			return Determinant();
 #endif // !NOT_SUPPORT_LAZY_EVALUATION
 		}
 
+		/// <summary> Solve <c>this * x = b</c>, routed by the structure like <c>Inv</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand sides as the columns. </param>
+		/// <returns> The solutions as the columns, empty if this is not square, singular, or the rows do not match. </returns>
+		template<int _LayoutB>
+		Matrix<_T, _LayoutB> Solve(const Matrix<_T, _LayoutB>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Solve");
+			row_major_type x(*b.value_);
+			if (!SolveInPlace(x))
+				return Matrix<_T, _LayoutB>();
+			return Matrix<_T, _LayoutB>(typename Matrix<_T, _LayoutB>::base_type(x));
+		}
+
+		/// <summary> Solve <c>this * x = b</c>, routed by the structure like <c>Inv</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="b"> The right-hand side. </param>
+		/// <returns> The solution, empty if this is not square, singular, or the sizes do not match. </returns>
+		template<int _Size>
+		Vector<_T, _Size> Solve(const Vector<_T, _Size>& b) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Solve");
+			row_major_type x = Eigen::Map<const Eigen::Matrix<_T, Eigen::Dynamic, 1> >(b.Data(), b.GetSize());
+			if (!SolveInPlace(x))
+				return Vector<_T, _Size>();
+			return Vector<_T, _Size>(typename Vector<_T, _Size>::base_type(x.col(0)));
+		}
+
+		/// <summary>
+		/// 	<para> Detect the structure in one pass over the values, cached for the matrix. </para>
+		/// 	<para> Opt-in: <c>Inv</c>, <c>DetGauss</c> and <c>Solve</c> are routed by the structure once
+		/// 	it is analyzed or assumed, or always when <c>NUDTTK_ENABLE_STRUCTURE_DETECTION</c> is defined. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The <c>Structure::Flags</c> combined, <c>Structure::General</c> if not square. </returns>
+		int AnalyzeStructure() const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::AnalyzeStructure");
+			return Structured().flags;
+		}
+
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+		/// <summary>
+		/// 	<para> Assert the structure without detection, e.g. <c>Structure::PositiveDefinite</c> of a
+		/// 	normal matrix. It holds until this is modified. </para>
+		/// 	<para> The caller is trusted, only the triangles the structure implies are read. Results
+		/// 	routed by another structure, e.g. a cached inverse, are dropped. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="flags">	 The <c>Structure::Flags</c> combined. </param>
+		/// <param name="bandwidth"> (Optional) The largest distance of a nonzero value from the diagonal,
+		/// 	required by <c>Structure::Banded</c>. </param>
+		void AssumeStructure(const int flags, const size_t bandwidth = 0) const {
+			structure_t structure = { flags, static_cast<Eigen::Index>(bandwidth) };
+			if (bandwidth == 0)
+				structure.flags &= ~Structure::Banded;
+			structure_t previous = { Structure::General, 0 };
+			value_.FindLazyValue("structure_value", previous);
+			if (previous.flags != structure.flags || previous.bandwidth != structure.bandwidth) {
+				value_.EraseLazyValue("inverse_value");
+				value_.EraseLazyValue("determinant_value");
+				value_.EraseLazyValue("cholesky_value");
+			}
+			value_.StoreLazyValue("structure_value", structure);
+		}
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+
+#if __cplusplus >= 201103L
+		/// <summary>
+		/// 	<para> Gets the inverse asynchronously, e.g. to overlap the factorization with I/O. </para>
+		/// 	<para> The task works on a copy sharing this value, so the inverse is cached for this
+		/// 	matrix as well unless this is modified meanwhile. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The future of the inverse, empty if this is singular. </returns>
+		std::future<Matrix<_T, _Layout>> InvAsync() const {
+			const Matrix<_T, _Layout> shared(*this);
+			return Async([shared]() { return shared.Inv(); });
+		}
+
+		/// <summary> Get matrix determinant value asynchronously, cached as by <c>InvAsync</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The future of the determinant value. </returns>
+		std::future<_T> DetGaussAsync() const {
+			const Matrix<_T, _Layout> shared(*this);
+			return Async([shared]() { return shared.DetGauss(); });
+		}
+
+	public:
+		/// <summary>
+		/// 	<para> Eigendecomposition of this symmetric matrix, e.g. a covariance, cached for the matrix. </para>
+		/// 	<para> Only the lower triangle is read. The cached eigenvectors are shared in O(1). </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="values">  [out] The eigenvalues in ascending order. </param>
+		/// <param name="vectors"> [out] The eigenvectors as the columns, in the order of the eigenvalues. </param>
+		/// <returns> True if it succeeds, false if this is not square or the solver does not converge. </returns>
+		bool Eigen(Vector<_T, Eigen::Dynamic>& values, Matrix<_T, _Layout>& vectors) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Eigen");
+			const decomposition_t eigen = EigenDecomposition();
+			if (!eigen.valid)
+				return false;
+			values = Vector<_T, Eigen::Dynamic>(eigen.values);
+			vectors = Matrix<_T, _Layout>(eigen.left);
+			return true;
+		}
+
+		/// <summary> The k largest eigenvalues of this symmetric matrix and their eigenvectors. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="k">	   Number of the eigenvalues, at most the size of this. </param>
+		/// <param name="values">  [out] The eigenvalues in descending order. </param>
+		/// <param name="vectors"> [out] The eigenvectors as the columns, in the order of the eigenvalues. </param>
+		/// <returns> True if it succeeds, false if this is not square, k is too large or the solver does
+		/// 	not converge. </returns>
+		bool Eigen(const size_t k, Vector<_T, Eigen::Dynamic>& values, Matrix<_T, _Layout>& vectors) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Eigen");
+			const decomposition_t eigen = EigenDecomposition();
+			if (!eigen.valid || k > static_cast<size_t>(eigen.values.size()))
+				return false;
+			const Eigen::Index count = static_cast<Eigen::Index>(k);
+			values = Vector<_T, Eigen::Dynamic>(values_t(eigen.values.tail(count).reverse()));
+			vectors = Matrix<_T, _Layout>(base_type(eigen.left->rightCols(count).rowwise().reverse()));
+			return true;
+		}
+
+		/// <summary>
+		/// 	<para> Thin singular value decomposition <c>U * diag(s) * V^T</c>, cached for the matrix. </para>
+		/// 	<para> BDCSVD is used for large matrices, one-sided Jacobi for small ones. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="singular_values"> [out] The singular values in descending order. </param>
+		/// <param name="u">			   [out] The left singular vectors as the columns. </param>
+		/// <param name="v">			   [out] The right singular vectors as the columns. </param>
+		/// <returns> True if it succeeds, false if this has non-finite values. </returns>
+		bool Svd(Vector<_T, Eigen::Dynamic>& singular_values, Matrix<_T, _Layout>& u, Matrix<_T, _Layout>& v) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Svd");
+			const decomposition_t svd = SingularValueDecomposition(true);
+			if (!svd.valid)
+				return false;
+			singular_values = Vector<_T, Eigen::Dynamic>(svd.values);
+			u = Matrix<_T, _Layout>(svd.left);
+			v = Matrix<_T, _Layout>(svd.right);
+			return true;
+		}
+
+		/// <summary> The k largest singular values and their singular vectors, see <c>Svd</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="k">			   Number of the singular values, at most the smaller size of this. </param>
+		/// <param name="singular_values"> [out] The singular values in descending order. </param>
+		/// <param name="u">			   [out] The left singular vectors as the columns. </param>
+		/// <param name="v">			   [out] The right singular vectors as the columns. </param>
+		/// <returns> True if it succeeds, false if k is too large or this has non-finite values. </returns>
+		bool Svd(const size_t k, Vector<_T, Eigen::Dynamic>& singular_values,
+				 Matrix<_T, _Layout>& u, Matrix<_T, _Layout>& v) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Svd");
+			const decomposition_t svd = SingularValueDecomposition(true);
+			if (!svd.valid || k > static_cast<size_t>(svd.values.size()))
+				return false;
+			const Eigen::Index count = static_cast<Eigen::Index>(k);
+			singular_values = Vector<_T, Eigen::Dynamic>(values_t(svd.values.head(count)));
+			u = Matrix<_T, _Layout>(base_type(svd.left->leftCols(count)));
+			v = Matrix<_T, _Layout>(base_type(svd.right->leftCols(count)));
+			return true;
+		}
+
+		/// <summary> Singular values only, cached for the matrix, see <c>Svd</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="singular_values"> [out] The singular values in descending order. </param>
+		/// <returns> True if it succeeds, false if this has non-finite values. </returns>
+		bool Svd(Vector<_T, Eigen::Dynamic>& singular_values) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Svd");
+			const decomposition_t svd = SingularValueDecomposition(false);
+			if (svd.valid)
+				singular_values = Vector<_T, Eigen::Dynamic>(svd.values);
+			return svd.valid;
+		}
+
+		/// <summary> Gets the 2-norm condition number, the ratio of the extreme singular values. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The condition number, infinity if this is singular, NaN if empty or not finite. </returns>
+		_T ConditionNumber() const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::ConditionNumber");
+			const decomposition_t svd = SingularValueDecomposition(false);
+			if (!svd.valid || svd.values.size() == 0)
+				return std::numeric_limits<_T>::quiet_NaN();
+			const _T smallest = svd.values(svd.values.size() - 1);
+			return smallest > _T(0) ? svd.values(0) / smallest : std::numeric_limits<_T>::infinity();
+		}
+
+		/// <summary> Gets the numerical rank, the number of singular values above the threshold. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="threshold"> (Optional) Threshold relative to the largest singular value,
+		/// 	negative (default) for the larger size of this times the machine epsilon. </param>
+		/// <returns> The rank, 0 if empty or not finite. </returns>
+		size_t Rank(_T threshold = _T(-1)) const {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Rank");
+			const decomposition_t svd = SingularValueDecomposition(false);
+			if (!svd.valid || svd.values.size() == 0)
+				return 0;
+			if (threshold < _T(0))
+				threshold = static_cast<_T>(std::max(GetNumRows(), GetNumColumns())) * std::numeric_limits<_T>::epsilon();
+			return static_cast<size_t>((svd.values.array() > threshold * svd.values(0)).count());
+		}
+#endif	// __cplusplus >= 201103L
+
+	public:
+		/// <summary>
+		/// 	<para> Destination-passing product <c>out = alpha * op(lhs) * op(rhs) + beta * out</c>,
+		/// 	where <c>op</c> optionally transposes. </para>
+		/// 	<para> The product is written straight into the storage of <c>out</c> without aliasing check,
+		/// 	nothing is allocated when <c>out</c> is owned exclusively and already has the result size,
+		/// 	and alpha is 1 or beta is 0. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">			 [in,out] The destination, MUST NOT be lhs or rhs. When beta is
+		/// 	not zero it MUST have the result size, otherwise it is resized. </param>
+		/// <param name="lhs">			 The left operand of any storage order. </param>
+		/// <param name="rhs">			 The right operand of any storage order. </param>
+		/// <param name="alpha">		 (Optional) Scale of the product. </param>
+		/// <param name="beta">			 (Optional) Scale of the original destination, 0 to ignore it. </param>
+		/// <param name="transpose_lhs"> (Optional) True to use the transpose of lhs. </param>
+		/// <param name="transpose_rhs"> (Optional) True to use the transpose of rhs. </param>
+		template<int _LayoutL, int _LayoutR>
+		static void Multiply(Matrix<_T, _Layout>& out, const Matrix<_T, _LayoutL>& lhs, const Matrix<_T, _LayoutR>& rhs,
+							 const _T alpha = _T(1), const _T beta = _T(0),
+							 const bool transpose_lhs = false, const bool transpose_rhs = false) {
+			NUDTTK_INSTRUMENT_SCOPE("Matrix::Multiply");
+			// A transpose is a view in the other storage order, GEMM takes either order as is
+			const typename Matrix<_T, _LayoutL>::base_type& lhs_value = *lhs.value_;
+			const typename Matrix<_T, _LayoutR>::base_type& rhs_value = *rhs.value_;
+			if (transpose_lhs) {
+				if (transpose_rhs)
+					MultiplyInto(out, lhs_value.transpose(), rhs_value.transpose(), alpha, beta);
+				else
+					MultiplyInto(out, lhs_value.transpose(), rhs_value, alpha, beta);
+			} else {
+				if (transpose_rhs)
+					MultiplyInto(out, lhs_value, rhs_value.transpose(), alpha, beta);
+				else
+					MultiplyInto(out, lhs_value, rhs_value, alpha, beta);
+			}
+		}
+
+#if __cplusplus >= 201103L
+		/// <summary> Asynchronous product <c>op(lhs) * op(rhs)</c>, see <c>Multiply</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="lhs">			 The left operand, shared by the task. </param>
+		/// <param name="rhs">			 The right operand, shared by the task. </param>
+		/// <param name="transpose_lhs"> (Optional) True to use the transpose of lhs. </param>
+		/// <param name="transpose_rhs"> (Optional) True to use the transpose of rhs. </param>
+		/// <returns> The future of the product. </returns>
+		template<int _LayoutL, int _LayoutR>
+		static std::future<Matrix<_T, _Layout>> MultiplyAsync(const Matrix<_T, _LayoutL>& lhs, const Matrix<_T, _LayoutR>& rhs,
+															  const bool transpose_lhs = false, const bool transpose_rhs = false) {
+			const Matrix<_T, _LayoutL> shared_lhs(lhs);
+			const Matrix<_T, _LayoutR> shared_rhs(rhs);
+			return Async([shared_lhs, shared_rhs, transpose_lhs, transpose_rhs]() {
+				Matrix<_T, _Layout> out;
+				Multiply(out, shared_lhs, shared_rhs, _T(1), _T(0), transpose_lhs, transpose_rhs);
+				return out;
+			});
+		}
+#endif	// __cplusplus >= 201103L
+
 	private:
-		base_type value_;	// The matrix value
+		template<typename, int>
+		friend class Matrix;
+		template<typename>
+		friend class DiagonalMatrix;
+		template<typename>
+		friend class NormalEquation;
+		template<typename>
+		friend class Covariance;
+
+		typedef _shared_storage<base_type> storage_t;
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> row_major_type;
+
+		/// <summary> Structure of this value, the bandwidth is the larger of the lower and upper ones. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct structure_t {
+			int flags;
+			Eigen::Index bandwidth;
+		};
+
+		/// <summary> Cholesky factor L of this value, dense, or n x (bandwidth + 1) if banded. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct factor_t {
+			bool valid;
+			Eigen::Index bandwidth;		// 0 for a dense factor
+			storage_t factor;
+		};
+
 #ifndef NOT_SUPPORT_LAZY_EVALUATION
-#ifdef _OPTIONAL_
-		using value_t = std::optional<base_type>;
-		using scalar_t = std::optional<_T>;
-		std::map<std::string, std::any> lazy_value_map_{
-#else	// BOOST_OPTIONAL_FLC_19NOV2002_HPP
-		using value_t = boost::optional<Matrix<_T>::base_type>;
-		using scalar_t = boost::optional<_T>;
-		std::map<std::string, boost::any> lazy_value_map_{
-#endif	// _OPTIONAL_
-			{"tranpose_value", value_t()},
-			{"absolute_value", value_t()},
-			{"inverse_value", value_t()},
-			{"determinant_value", scalar_t()}
+		/// <summary> Find a result of an equal value computed by any matrix, see <c>ResultCache</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="key">	   The cache entry name, as of the lazy value. </param>
+		/// <param name="variant"> The variant of the operation, e.g. the structure it is routed by. </param>
+		/// <param name="cached">  [out] The cached result. </param>
+		/// <returns> True if found, false if not or the result cache is disabled. </returns>
+		template<typename _Cached>
+		bool FindSharedValue(const char* key, const long variant, _Cached& cached) const {
+			if (!ResultCache::Enabled())
+				return false;
+			const bool found = _result_cache::Instance().Find(ContentKey(), key, variant, cached);
+			NUDTTK_INSTRUMENT_CACHE("result_cache", found);
+			return found;
+		}
+
+		/// <summary> Share a result with every matrix of an equal value, see <c>ResultCache</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="key">	   The cache entry name. </param>
+		/// <param name="variant"> The variant of the operation. </param>
+		/// <param name="cached">  The result. </param>
+		/// <param name="bytes">   Bytes held by the result. </param>
+		template<typename _Cached>
+		void StoreSharedValue(const char* key, const long variant, const _Cached& cached, const size_t bytes) const {
+			if (ResultCache::Enabled())
+				_result_cache::Instance().Store(ContentKey(), key, variant, cached, bytes);
+		}
+
+		/// <summary> Key of this value in the result cache, the hash is cached for the matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_result_key ContentKey() const {
+			const base_type& value = *value_;
+			const size_t bytes = static_cast<size_t>(value.size()) * sizeof(_T);
+			std::uint64_t hash = 0;
+			if (!value_.FindLazyValue("content_hash", hash)) {
+				hash = _content_hash(value.data(), bytes);
+				value_.StoreLazyValue("content_hash", hash);
+			}
+			const _result_key key = { &typeid(base_type), value.data(), bytes,
+									  static_cast<size_t>(value.rows()), static_cast<size_t>(value.cols()), hash };
+			return key;
+		}
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+
+		/// <summary> Cached structure of this value, detected if neither analyzed nor assumed. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		structure_t Structured() const {
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			structure_t lazy_value = { Structure::General, 0 };
+			const bool cached = value_.FindLazyValue("structure_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("structure_value", cached);
+			if (!cached) {
+				lazy_value = DetectStructure();
+				value_.StoreLazyValue("structure_value", lazy_value);
+			}
+			return lazy_value;
+#else
+			return DetectStructure();
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+		}
+
+		/// <summary> Structure routing <c>Inv</c>, <c>DetGauss</c> and <c>Solve</c>, general unless opted in. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		structure_t Routing() const {
+			structure_t structure = { Structure::General, 0 };
+			if (value_->rows() != value_->cols())
+				return structure;
+#if defined(NUDTTK_ENABLE_STRUCTURE_DETECTION)
+			structure = Structured();
+#elif !defined(NOT_SUPPORT_LAZY_EVALUATION)
+			value_.FindLazyValue("structure_value", structure);
+#endif	// NUDTTK_ENABLE_STRUCTURE_DETECTION
+			return structure;
+		}
+
+		/// <summary> Detect the bandwidths and the symmetry in one pass over the strict lower triangle. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		structure_t DetectStructure() const {
+			const base_type& value = *value_;
+			const Eigen::Index n = value.rows();
+			structure_t result = { Structure::General, 0 };
+			if (n == 0 || n != value.cols())
+				return result;
+			const _T tolerance = _T(16) * std::numeric_limits<_T>::epsilon();
+			Eigen::Index lower = 0, upper = 0;
+			bool symmetric = true;
+			for (Eigen::Index i = 1; i < n; i++) {
+				for (Eigen::Index j = 0; j < i; j++) {
+					const _T below = value(i, j), above = value(j, i);
+					if (below != _T(0))
+						lower = std::max(lower, i - j);
+					if (above != _T(0))
+						upper = std::max(upper, i - j);
+					if (symmetric && std::abs(below - above) > tolerance * std::max(std::abs(below), std::abs(above)))
+						symmetric = false;
+				}
+			}
+			if (lower == 0 && upper == 0)
+				result.flags = Structure::Diagonal;
+			else if (upper == 0)
+				result.flags = Structure::Lower;
+			else if (lower == 0)
+				result.flags = Structure::Upper;
+			if (symmetric)
+				result.flags |= Structure::Symmetric;
+			// A band is worth its own factorization only if much narrower than the matrix
+			result.bandwidth = std::max(lower, upper);
+			if (result.bandwidth > 0 && result.bandwidth * 8 <= n)
+				result.flags |= Structure::Banded;
+			return result;
+		}
+
+		/// <summary> Cached Cholesky factor of this symmetric value, invalid if not positive definite. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		factor_t CholeskyFactor(const structure_t& structure) const {
+			const Eigen::Index bandwidth = (structure.flags & Structure::Banded) ? structure.bandwidth : 0;
+			factor_t lazy_value = { false, bandwidth, storage_t() };
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			// A factor of another bandwidth, e.g. cached before the structure is assumed again, is refactored
+			const bool cached = value_.FindLazyValue("cholesky_value", lazy_value) && lazy_value.bandwidth == bandwidth;
+			NUDTTK_INSTRUMENT_CACHE("cholesky_value", cached);
+			if (cached)
+				return lazy_value;
+			lazy_value.valid = false;
+			lazy_value.bandwidth = bandwidth;
+			lazy_value.factor = storage_t();
+			const long variant = static_cast<long>(bandwidth);
+			if (FindSharedValue("cholesky_value", variant, lazy_value)) {
+				value_.StoreLazyValue("cholesky_value", lazy_value);
+				return lazy_value;
+			}
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+			const base_type& value = *value_;
+			// A symmetric matrix with a nonpositive diagonal value is never positive definite
+			if ((value.diagonal().array() > _T(0)).all()) {
+				if (bandwidth > 0) {
+					base_type band;
+					lazy_value.valid = BandCholesky(value, bandwidth, band);
+					lazy_value.factor = band;
+				} else {
+					const Eigen::LLT<row_major_type> llt(value);
+					lazy_value.valid = llt.info() == Eigen::Success;
+					lazy_value.factor = base_type(llt.matrixL());
+				}
+			}
+#ifndef NOT_SUPPORT_LAZY_EVALUATION
+			StoreSharedValue("cholesky_value", variant, lazy_value, lazy_value.factor->size() * sizeof(_T));
+			value_.StoreLazyValue("cholesky_value", lazy_value);
+#endif // !NOT_SUPPORT_LAZY_EVALUATION
+			return lazy_value;
+		}
+
+		/// <summary>
+		/// 	<para> Cholesky factorization of a band in O(n b^2), only the lower band of value is read. </para>
+		/// 	<para> L(i, j) of <c>i - b &lt;= j &lt;= i</c> is stored at <c>band(i, b + j - i)</c>. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		static bool BandCholesky(const base_type& value, const Eigen::Index b, base_type& band) {
+			const Eigen::Index n = value.rows();
+			band.setZero(n, b + 1);
+			for (Eigen::Index i = 0; i < n; i++) {
+				for (Eigen::Index j = std::max<Eigen::Index>(0, i - b); j <= i; j++) {
+					_T sum = value(i, j);
+					for (Eigen::Index k = std::max<Eigen::Index>(0, i - b); k < j; k++)
+						sum -= band(i, b + k - i) * band(j, b + k - j);
+					if (j < i) {
+						band(i, b + j - i) = sum / band(j, b);
+					} else if (sum > _T(0)) {
+						band(i, b) = std::sqrt(sum);
+					} else {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/// <summary> Solve <c>L L^T x = x</c> in place by the band of L, see <c>BandCholesky</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		static void BandSolveInPlace(const base_type& band, row_major_type& x) {
+			const Eigen::Index n = band.rows(), b = band.cols() - 1;
+			for (Eigen::Index i = 0; i < n; i++) {
+				for (Eigen::Index k = std::max<Eigen::Index>(0, i - b); k < i; k++)
+					x.row(i) -= band(i, b + k - i) * x.row(k);
+				x.row(i) /= band(i, b);
+			}
+			for (Eigen::Index i = n - 1; i >= 0; i--) {
+				for (Eigen::Index k = i + 1; k <= std::min(n - 1, i + b); k++)
+					x.row(i) -= band(k, b + i - k) * x.row(k);
+				x.row(i) /= band(i, b);
+			}
+		}
+
+		/// <summary> Solve <c>this * x = x</c> in place, routed by the structure. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> False if this is not square, singular, or the rows of x do not match. </returns>
+		bool SolveInPlace(row_major_type& x) const {
+			const base_type& value = *value_;
+			if (value.rows() != value.cols() || x.rows() != value.rows())
+				return false;
+			const structure_t structure = Routing();
+			if (structure.flags & (Structure::Diagonal | Structure::Lower | Structure::Upper)) {
+				if ((value.diagonal().array() == _T(0)).any())
+					return false;
+				if (structure.flags & Structure::Diagonal) {
+					for (Eigen::Index i = 0; i < x.rows(); i++)
+						x.row(i) /= value(i, i);
+				} else if (structure.flags & Structure::Lower) {
+					value.template triangularView<Eigen::Lower>().solveInPlace(x);
+				} else {
+					value.template triangularView<Eigen::Upper>().solveInPlace(x);
+				}
+				return true;
+			}
+			if (structure.flags & (Structure::Symmetric | Structure::PositiveDefinite)) {
+				const factor_t cholesky = CholeskyFactor(structure);
+				if (cholesky.valid) {
+					const base_type& factor = *cholesky.factor;
+					if (structure.flags & Structure::Banded) {
+						BandSolveInPlace(factor, x);
+					} else {
+						factor.template triangularView<Eigen::Lower>().solveInPlace(x);
+						factor.transpose().template triangularView<Eigen::Upper>().solveInPlace(x);
+					}
+					return true;
+				}
+			}
+			const Eigen::FullPivLU<base_type> lu(value);
+			if (!lu.isInvertible())
+				return false;
+			x = row_major_type(lu.solve(x));
+			return true;
+		}
+
+		/// <summary> Inverse of this value, routed by the structure. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> False if this is not square or singular. </returns>
+		bool Invert(base_type& inverse) const {
+			if (Routing().flags == Structure::General) {
+				Eigen::FullPivLU<base_type> lu(*value_);
+				if (!lu.isInvertible())
+					return false;
+				inverse = value_->inverse();
+				return true;
+			}
+			row_major_type x = row_major_type::Identity(value_->rows(), value_->cols());
+			if (!SolveInPlace(x))
+				return false;
+			inverse = x;
+			return true;
+		}
+
+		/// <summary> Determinant of this value, routed by the structure. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_T Determinant() const {
+			const structure_t structure = Routing();
+			if (structure.flags & (Structure::Diagonal | Structure::Lower | Structure::Upper))
+				return value_->diagonal().prod();
+			if (structure.flags & (Structure::Symmetric | Structure::PositiveDefinite)) {
+				const factor_t cholesky = CholeskyFactor(structure);
+				if (cholesky.valid) {
+					const base_type& factor = *cholesky.factor;
+					const _T root = (structure.flags & Structure::Banded) ? factor.col(factor.cols() - 1).prod()
+																		  : factor.diagonal().prod();
+					return root * root;
+				}
+			}
+			return value_->determinant();
+		}
+
+#if __cplusplus >= 201103L
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, 1> values_t;
+		// Decompositions are computed on column-major values, which every Eigen solver supports
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic> col_major_type;
+
+		/// <summary> Cached decomposition, the vectors are shared by the matrices returned. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct decomposition_t {
+			bool valid;
+			values_t values;
+			storage_t left, right;
 		};
-#endif	// !NOT_SUPPORT_LAZY_EVALUATION
+
+		/// <summary> Cached eigendecomposition of this symmetric value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		decomposition_t EigenDecomposition() const {
+			decomposition_t lazy_value = { false, values_t(), storage_t(), storage_t() };
+			const bool cached = value_.FindLazyValue("eigen_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("eigen_value", cached);
+			if (!cached) {
+				if (!FindSharedValue("eigen_value", 0, lazy_value)) {
+					if (value_->rows() == value_->cols()) {
+						const Eigen::SelfAdjointEigenSolver<col_major_type> solver{ col_major_type(*value_) };
+						lazy_value.valid = solver.info() == Eigen::Success;
+						if (lazy_value.valid) {
+							lazy_value.values = solver.eigenvalues();
+							lazy_value.left = base_type(solver.eigenvectors());
+						}
+					}
+					StoreSharedValue("eigen_value", 0, lazy_value, Bytes(lazy_value));
+				}
+				value_.StoreLazyValue("eigen_value", lazy_value);
+			}
+			return lazy_value;
+		}
+
+		/// <summary>
+		/// 	<para> Cached singular value decomposition of this value. </para>
+		/// 	<para> The singular values are also taken from a cached decomposition with the vectors. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="vectors"> True to compute the thin singular vectors as well. </param>
+		decomposition_t SingularValueDecomposition(const bool vectors) const {
+			decomposition_t lazy_value = { false, values_t(), storage_t(), storage_t() };
+			bool cached = value_.FindLazyValue("svd_value", lazy_value);
+			NUDTTK_INSTRUMENT_CACHE("svd_value", cached);
+			if (!cached && !vectors) {
+				cached = value_.FindLazyValue("singular_value", lazy_value);
+				NUDTTK_INSTRUMENT_CACHE("singular_value", cached);
+			}
+			if (!cached) {
+				const char* key = vectors ? "svd_value" : "singular_value";
+				if (!FindSharedValue(key, 0, lazy_value)) {
+					const col_major_type value(*value_);
+					const unsigned int options = vectors ? Eigen::ComputeThinU | Eigen::ComputeThinV : 0;
+					// Divide and conquer pays off beyond the size Eigen itself swaps to Jacobi at
+					if (std::min(value.rows(), value.cols()) > 16)
+						lazy_value = Decompose(Eigen::BDCSVD<col_major_type>(value, options), vectors);
+					else
+						lazy_value = Decompose(Eigen::JacobiSVD<col_major_type>(value, options), vectors);
+					StoreSharedValue(key, 0, lazy_value, Bytes(lazy_value));
+				}
+				value_.StoreLazyValue(key, lazy_value);
+			}
+			return lazy_value;
+		}
+
+		template<typename _Solver>
+		static decomposition_t Decompose(const _Solver& solver, const bool vectors) {
+			// The SVD solvers always converge, non-finite values are the only failure
+			decomposition_t result = { solver.singularValues().allFinite(), values_t(), storage_t(), storage_t() };
+			if (result.valid) {
+				result.values = solver.singularValues();
+				if (vectors) {
+					result.left = base_type(solver.matrixU());
+					result.right = base_type(solver.matrixV());
+				}
+			}
+			return result;
+		}
+
+		static size_t Bytes(const decomposition_t& decomposition) _NOEXCEPT {
+			return static_cast<size_t>(decomposition.values.size() + decomposition.left->size() +
+									   decomposition.right->size()) * sizeof(_T);
+		}
+#endif	// __cplusplus >= 201103L
+
+		/// <summary> Evaluate <c>out = alpha * lhs * rhs + beta * out</c> for (transposed) values. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">   The destination. </param>
+		/// <param name="lhs">   The left value or its transpose. </param>
+		/// <param name="rhs">   The right value or its transpose. </param>
+		/// <param name="alpha"> The product scale. </param>
+		/// <param name="beta">  The destination scale. </param>
+		template<typename _Lhs, typename _Rhs>
+		static void MultiplyInto(Matrix<_T, _Layout>& out, const _Lhs& lhs, const _Rhs& rhs, const _T alpha, const _T beta) {
+			// Member call syntax keeps the expression operators of this namespace, which also match Eigen
+			// expressions, out of overload resolution
+			if (beta == _T(0)) {
+				base_type& value = out.value_.Overwrite();
+				value.resize(lhs.rows(), rhs.cols());
+				value.noalias() = lhs.operator*(rhs);
+				if (alpha != _T(1))
+					value *= alpha;
+			} else {
+				base_type& value = out.value_.Mutable();
+				if (beta != _T(1))
+					value *= beta;
+				if (alpha == _T(1)) {
+					value.noalias() += lhs.operator*(rhs);
+				} else {
+					// Folded into GEMM, small products evaluate the scaled lhs first
+					value.noalias() += lhs.operator*(alpha).operator*(rhs);
+				}
+			}
+		}
+
+		/// <summary> Add or subtract a matrix product straight into this (GEMM with beta = 1). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op">		The product. </param>
+		/// <param name="subtract"> True to subtract. </param>
+		/// <returns> This. </returns>
+		template<int _LayoutL, int _LayoutR>
+		Matrix<_T, _Layout>& AccumulateProduct(const mul_op_impl<Matrix<_T, _LayoutL>, Matrix<_T, _LayoutR>>& op, const bool subtract) {
+			const typename Matrix<_T, _LayoutL>::base_type& lhs = *op.lhs().value_;
+			const typename Matrix<_T, _LayoutR>::base_type& rhs = *op.rhs().value_;
+			// A shared value is detached here, so an operand can only alias when it is this
+			base_type& value = value_.Mutable();
+			if (value.data() == lhs.data() || value.data() == rhs.data()) {
+				if (subtract)
+					value -= lhs * rhs;
+				else
+					value += lhs * rhs;
+			} else {
+				if (subtract)
+					value.noalias() -= lhs * rhs;
+				else
+					value.noalias() += lhs * rhs;
+			}
+			return *this;
+		}
+
+		/// <summary> Share a stored value. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value. </param>
+		explicit Matrix(const storage_t& value) _NOEXCEPT
+			: value_(value) {}
+
+		// The matrix value, shared by copies together with lazy evaluation values
+		storage_t value_;
 	};
+
+	/// <summary>
+	/// 	<para> Destination-passing product <c>out = alpha * op(lhs) * op(rhs) + beta * out</c>. </para>
+	/// 	<para> Reuses one buffer in inner loops, e.g. chaining state transition matrices with two
+	/// 	buffers swapped per step. See <c>Matrix::Multiply</c>. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="out">			 [in,out] The destination, MUST NOT be lhs or rhs. </param>
+	/// <param name="lhs">			 The left operand. </param>
+	/// <param name="rhs">			 The right operand. </param>
+	/// <param name="alpha">		 (Optional) Scale of the product. </param>
+	/// <param name="beta">			 (Optional) Scale of the original destination, 0 to ignore it. </param>
+	/// <param name="transpose_lhs"> (Optional) True to use the transpose of lhs. </param>
+	/// <param name="transpose_rhs"> (Optional) True to use the transpose of rhs. </param>
+	template<typename _T, int _Layout, int _LayoutL, int _LayoutR>
+	inline void Multiply(Matrix<_T, _Layout>& out, const Matrix<_T, _LayoutL>& lhs, const Matrix<_T, _LayoutR>& rhs,
+						 const typename Matrix<_T, _Layout>::base_type::Scalar alpha = 1,
+						 const typename Matrix<_T, _Layout>::base_type::Scalar beta = 0,
+						 const bool transpose_lhs = false, const bool transpose_rhs = false) {
+		Matrix<_T, _Layout>::Multiply(out, lhs, rhs, alpha, beta, transpose_lhs, transpose_rhs);
+	}
+
+#if __cplusplus >= 201103L
+	// Operators on a temporary Matrix are evaluated eagerly into its storage, e.g. std::move(a) + b
+	// writes into a, and a chain of temporaries allocates once
+
+	template<typename _T, int _Layout, int _OtherLayout>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator+(Matrix<_T, _Layout>&& lhs, const Matrix<_T, _OtherLayout>& rhs) _NOEXCEPT {
+		lhs += rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _T, int _Layout, int _OtherLayout>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator+(const Matrix<_T, _OtherLayout>& lhs, Matrix<_T, _Layout>&& rhs) _NOEXCEPT {
+		rhs += lhs;
+		return std::move(rhs);
+	}
+
+	template<typename _T, int _Layout, int _OtherLayout>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator+(Matrix<_T, _Layout>&& lhs, Matrix<_T, _OtherLayout>&& rhs) _NOEXCEPT {
+		lhs += rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _T, int _Layout, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator+(Matrix<_T, _Layout>&& lhs, const _Impl<_Lhs, _Rhs>& rhs) _NOEXCEPT {
+		lhs += rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _T, int _Layout, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator+(const _Impl<_Lhs, _Rhs>& lhs, Matrix<_T, _Layout>&& rhs) _NOEXCEPT {
+		rhs += lhs;
+		return std::move(rhs);
+	}
+
+	template<typename _T, int _Layout, int _OtherLayout>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator-(Matrix<_T, _Layout>&& lhs, const Matrix<_T, _OtherLayout>& rhs) _NOEXCEPT {
+		lhs -= rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _T, int _Layout, int _OtherLayout>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator-(Matrix<_T, _Layout>&& lhs, Matrix<_T, _OtherLayout>&& rhs) _NOEXCEPT {
+		lhs -= rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _T, int _Layout, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator-(Matrix<_T, _Layout>&& lhs, const _Impl<_Lhs, _Rhs>& rhs) _NOEXCEPT {
+		lhs -= rhs;
+		return std::move(lhs);
+	}
+
+	template<typename _Scalar, typename _T, int _Layout,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator*(Matrix<_T, _Layout>&& lhs, const _Scalar& rhs) _NOEXCEPT {
+		lhs *= static_cast<_T>(rhs);
+		return std::move(lhs);
+	}
+
+	template<typename _Scalar, typename _T, int _Layout,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator*(const _Scalar& lhs, Matrix<_T, _Layout>&& rhs) _NOEXCEPT {
+		rhs *= static_cast<_T>(lhs);
+		return std::move(rhs);
+	}
+
+	template<typename _Scalar, typename _T, int _Layout,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+	_CONSTEXPR_FN Matrix<_T, _Layout> operator/(Matrix<_T, _Layout>&& lhs, const _Scalar& rhs) _NOEXCEPT {
+		lhs /= static_cast<_T>(rhs);
+		return std::move(lhs);
+	}
+#endif	// __cplusplus >= 201103L
 }
 
 
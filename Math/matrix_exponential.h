@@ -0,0 +1,209 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_MATRIX_EXPONENTIAL_TR_
+#define _NUDTTK_MATH_MATRIX_EXPONENTIAL_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> Matrix exponential <c>exp(A * dt)</c> of a square matrix by Pade approximants with
+	/// 	scaling and squaring (Higham 2005), e.g. state transition matrices of linear dynamics. </para>
+	/// 	<para> With a fixed size, e.g. <c>MatrixExponential&lt;double, 6&gt;</c>, every value lives on
+	/// 	the stack and nothing is allocated on the heap. The even powers of A are computed once, so each
+	/// 	<c>dt</c> of a batch costs sums of scaled powers, one or two products, one LU solve and the
+	/// 	squarings, instead of forming the powers of <c>A * dt</c> again. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T">	 Type of the t. </typeparam>
+	/// <typeparam name="_Size"> The size of the matrix, <c>Eigen::Dynamic</c> for a size at run time. </typeparam>
+	template<typename _T = double, int _Size = Eigen::Dynamic>
+	class MatrixExponential {
+	public:
+		typedef Eigen::Matrix<_T, _Size, _Size, Eigen::RowMajor> value_type;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	public:
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="a"> The square matrix A. </param>
+		explicit MatrixExponential(const value_type& a) {
+			Initialize(a);
+		}
+
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="a">	The square matrix A row by row. </param>
+		/// <param name="size"> (Optional) The size of A, MUST be given for a dynamic size. </param>
+		explicit MatrixExponential(const _T a[], const size_t size = _Size > 0 ? _Size : 0) {
+			const Eigen::Index n = static_cast<Eigen::Index>(size);
+			Initialize(Eigen::Map<const value_type>(a, n, n));
+		}
+
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="a"> The square matrix A, MUST have the fixed size if any. </param>
+		template<int _Layout>
+		explicit MatrixExponential(const Matrix<_T, _Layout>& a) {
+			Initialize(a.unwrap());
+		}
+
+	public:
+		/// <summary> Gets the size of A. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		size_t GetSize() const _NOEXCEPT {
+			return static_cast<size_t>(a_.rows());
+		}
+
+		/// <summary> Evaluate exp(A * dt). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="dt">  The step, e.g. the time from the epoch of the state. </param>
+		/// <param name="out"> [out] The exponential. </param>
+		void Evaluate(const _T dt, value_type& out) const {
+			NUDTTK_INSTRUMENT_SCOPE("MatrixExponential::Evaluate");
+			// Theta of degree 3, 5, 7, 9 and 13 for double, Table 2.3 of Higham (2005)
+			static const _T theta[] = { _T(1.495585217958292e-2), _T(2.539398330063230e-1),
+										_T(9.504178996162932e-1), _T(2.097847961257068e0), _T(5.371920351148152e0) };
+			static const int degrees[] = { 3, 5, 7, 9 };
+			const _T norm = norm_ * std::abs(dt);
+			value_type u, v;
+			int squarings = 0;
+			size_t index = 0;
+			while (index < 4 && norm > theta[index])
+				index++;
+			if (index < 4) {
+				Pade(degrees[index], dt, u, v);
+			} else {
+				// Scale A * dt by 2^-s into the range of degree 13
+				const _T fraction = std::frexp(norm / theta[4], &squarings);
+				if (fraction == _T(0.5))
+					squarings--;
+				if (squarings < 0)
+					squarings = 0;
+				Pade13(std::ldexp(dt, -squarings), u, v);
+			}
+			// r = (V - U)^-1 (V + U), squared s times
+			out = (v - u).partialPivLu().solve(v + u);
+			for (int i = 0; i < squarings; i++)
+				out = out * out;
+		}
+
+		/// <summary> Evaluate exp(A * dt). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="dt"> The step. </param>
+		/// <returns> The exponential. </returns>
+		value_type Evaluate(const _T dt) const {
+			value_type out;
+			Evaluate(dt, out);
+			return out;
+		}
+
+		/// <summary> Evaluate exp(A * dt) on an array. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="dt">  The step. </param>
+		/// <param name="out"> [out] The exponential row by row, the caller MUST ensure there are size * size values. </param>
+		void Evaluate(const _T dt, _T out[]) const {
+			Eigen::Map<value_type>(out, a_.rows(), a_.cols()) = Evaluate(dt);
+		}
+
+		/// <summary> Evaluate exp(A * dt) for a batch of steps sharing A. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="dt">	 The steps. </param>
+		/// <param name="count"> Number of the steps. </param>
+		/// <param name="out">	 [out] The exponentials one after another, each row by row, the caller MUST
+		/// 	ensure there are count * size * size values. </param>
+		void Evaluate(const _T dt[], const size_t count, _T out[]) const {
+			NUDTTK_INSTRUMENT_SCOPE("MatrixExponential::EvaluateBatch");
+			const size_t stride = static_cast<size_t>(a_.size());
+			for (size_t k = 0; k < count; k++)
+				Evaluate(dt[k], out + k * stride);
+		}
+
+	private:
+		template<typename _Value>
+		void Initialize(const _Value& a) {
+			a_ = a;
+			a2_ = a_ * a_;
+			a4_ = a2_ * a2_;
+			a6_ = a4_ * a2_;
+			a8_ = a4_ * a4_;
+			// The 1-norm, the largest absolute column sum
+			norm_ = a_.size() > 0 ? a_.cwiseAbs().colwise().sum().maxCoeff() : _T(0);
+		}
+
+		/// <summary> U and V of the Pade approximant of degree 3, 5, 7 or 9 of A * dt. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		void Pade(const int degree, const _T dt, value_type& u, value_type& v) const {
+			static const _T b3[] = { 120, 60, 12, 1 };
+			static const _T b5[] = { 30240, 15120, 3360, 420, 30, 1 };
+			static const _T b7[] = { 17297280, 8648640, 1995840, 277200, 25200, 1512, 56, 1 };
+			static const _T b9[] = { 17643225600., 8821612800., 2075673600., 302702400., 30270240.,
+									 2162160., 110880., 3960., 90., 1. };
+			const _T* b = degree == 3 ? b3 : degree == 5 ? b5 : degree == 7 ? b7 : b9;
+			const value_type* powers[] = { &a2_, &a4_, &a6_, &a8_ };
+
+			// V = sum b_2k (A dt)^2k, U = A dt sum b_2k+1 (A dt)^2k
+			value_type odd;
+			v.setIdentity(a_.rows(), a_.cols());
+			v *= b[0];
+			odd.setIdentity(a_.rows(), a_.cols());
+			odd *= b[1] * dt;
+			_T scale = _T(1);
+			for (int k = 1; 2 * k < degree; k++) {
+				scale *= dt * dt;
+				v += (b[2 * k] * scale) * *powers[k - 1];
+				odd += (b[2 * k + 1] * scale * dt) * *powers[k - 1];
+			}
+			u.noalias() = a_ * odd;
+		}
+
+		/// <summary> U and V of the Pade approximant of degree 13 of A * dt. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		void Pade13(const _T dt, value_type& u, value_type& v) const {
+			static const _T b[] = { 64764752532480000., 32382376266240000., 7771770303897600.,
+									1187353796428800., 129060195264000., 10559470521600., 670442572800.,
+									33522128640., 1323241920., 40840800., 960960., 16380., 182., 1. };
+			const _T t2 = dt * dt, t4 = t2 * t2, t6 = t4 * t2;
+			const value_type identity = value_type::Identity(a_.rows(), a_.cols());
+
+			// With B = A dt: U = B [B6 (b13 B6 + b11 B4 + b9 B2) + b7 B6 + b5 B4 + b3 B2 + b1 I]
+			value_type high = (b[13] * t6) * a6_ + (b[11] * t4) * a4_ + (b[9] * t2) * a2_;
+			value_type low = (b[7] * t6) * a6_ + (b[5] * t4) * a4_ + (b[3] * t2) * a2_ + b[1] * identity;
+			high *= t6;
+			low.noalias() += a6_ * high;
+			low *= dt;
+			u.noalias() = a_ * low;
+
+			// V = B6 (b12 B6 + b10 B4 + b8 B2) + b6 B6 + b4 B4 + b2 B2 + b0 I
+			high = (b[12] * t6) * a6_ + (b[10] * t4) * a4_ + (b[8] * t2) * a2_;
+			v = (b[6] * t6) * a6_ + (b[4] * t4) * a4_ + (b[2] * t2) * a2_ + b[0] * identity;
+			high *= t6;
+			v.noalias() += a6_ * high;
+		}
+
+		value_type a_, a2_, a4_, a6_, a8_;
+		_T norm_;
+	};
+
+	/// <summary> Matrix exponential exp(A * dt) of a matrix, see <c>MatrixExponential</c>. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="a">  The square matrix. </param>
+	/// <param name="dt"> (Optional) The step, 1 by default. </param>
+	/// <returns> The exponential, empty if a is not square. </returns>
+	template<typename _T, int _Layout>
+	Matrix<_T, _Layout> MatrixExp(const Matrix<_T, _Layout>& a, const _T dt = _T(1)) {
+		if (a.GetNumRows() != a.GetNumColumns())
+			return Matrix<_T, _Layout>();
+		const MatrixExponential<_T> exponential(a);
+		return Matrix<_T, _Layout>(typename Matrix<_T, _Layout>::base_type(exponential.Evaluate(dt)));
+	}
+}
+
+#endif	// !_NUDTTK_MATH_MATRIX_EXPONENTIAL_TR_
@@ -0,0 +1,346 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_NORMAL_EQUATION_TR_
+#define _NUDTTK_MATH_NORMAL_EQUATION_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+#include "parallel.h"
+
+#include <vector>
+
+#if __cplusplus < 201103L
+#error You need to compile normal equations with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	template<typename _T = double>
+	class NormalEquation;
+
+	/// <summary>
+	/// 	<para> Normal equation <c>N x = b</c> of a least squares adjustment. </para>
+	/// 	<para> Normal equations of different days or stations are combined by <c>Add</c> or
+	/// 	<c>Stack</c> through index maps onto the combined parameters. Runs of consecutive indices are
+	/// 	added as blocks, and N is written in place, so its lazy evaluation values are dropped once. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T>
+	class NormalEquation {
+	public:
+		typedef typename Matrix<_T>::base_type dense_type;
+		typedef typename Vector<_T>::base_type vector_type;
+
+	public:
+		/// <summary> Default constructor (no thing to do). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		NormalEquation() _NOEXCEPT {}
+
+		/// <summary> Initialize zero NormalEquation in number of parameters. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size"> Number of the parameters. </param>
+		explicit NormalEquation(const size_t size)
+			: normal_(size, size), rhs_(size) {}
+
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="normal"> The symmetric normal matrix N. </param>
+		/// <param name="rhs">	  The right-hand side b, MUST have the size of N. </param>
+		NormalEquation(const Matrix<_T>& normal, const Vector<_T>& rhs)
+			: normal_(normal), rhs_(rhs) {}
+
+	public:
+		/// <summary> Gets number of the parameters. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The number of parameters. </returns>
+		size_t GetNumParameters() const _NOEXCEPT {
+			return rhs_.GetSize();
+		}
+
+		/// <summary> Gets the normal matrix N, shared in O(1). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The normal matrix. </returns>
+		const Matrix<_T>& GetNormalMatrix() const _NOEXCEPT {
+			return normal_;
+		}
+
+		/// <summary> Gets the right-hand side b. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The right-hand side. </returns>
+		const Vector<_T>& GetRightHandSide() const _NOEXCEPT {
+			return rhs_;
+		}
+
+		/// <summary> Solve the normal equation by Cholesky factorization. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The parameters, empty if N is not positive definite. </returns>
+		Vector<_T> Solve() const {
+			NUDTTK_INSTRUMENT_SCOPE("NormalEquation::Solve");
+			const Eigen::LLT<typename Matrix<_T>::base_type> llt(normal_.unwrap());
+			if (llt.info() != Eigen::Success)
+				return Vector<_T>();
+			return Vector<_T>(typename Vector<_T>::base_type(llt.solve(rhs_.unwrap())));
+		}
+
+		/// <summary> Add another normal equation whose parameter i is parameter <c>index_map[i]</c> of this. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other">	 The other normal equation. </param>
+		/// <param name="index_map"> The index map, one index of this per parameter of other. </param>
+		/// <returns> False if the index map does not fit, nothing is changed. </returns>
+		bool Add(const NormalEquation<_T>& other, const std::vector<size_t>& index_map) {
+			NUDTTK_INSTRUMENT_SCOPE("NormalEquation::Add");
+			std::vector<_run> runs;
+			if (!MakeRuns(index_map, other.GetNumParameters(), GetNumParameters(), runs))
+				return false;
+			// Sharing the storage of other detaches this when other is this
+			const Matrix<_T> other_normal = other.normal_;
+			const vector_type other_rhs = other.rhs_.unwrap();
+			dense_type& normal = normal_.value_.Mutable();
+			Eigen::Map<vector_type> rhs(rhs_.Data(), rhs_.GetSize());
+			AddRuns(other_normal.unwrap(), other_rhs, runs, 0, normal.rows(), normal, rhs);
+			return true;
+		}
+
+		/// <summary>
+		/// 	<para> Stack normal equations into one over <c>size</c> parameters, where parameter i of
+		/// 	equation k is parameter <c>index_maps[k][i]</c> of the stacked one. </para>
+		/// 	<para> The stacked system is written in one pass. Its rows are split into bands, and a worker
+		/// 	adds the contributions of every equation to its band, so no two workers write the same
+		/// 	entries and the sum does not depend on the scheduling. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="equations">  The normal equations. </param>
+		/// <param name="index_maps"> The index maps, one per equation. </param>
+		/// <param name="size">		  Number of the stacked parameters. </param>
+		/// <param name="stacked">	  [out] The stacked normal equation. </param>
+		/// <returns> False if an index map does not fit. </returns>
+		static bool Stack(const std::vector<NormalEquation<_T>>& equations, const std::vector<std::vector<size_t>>& index_maps,
+						  const size_t size, NormalEquation<_T>& stacked) {
+			NUDTTK_INSTRUMENT_SCOPE("NormalEquation::Stack");
+			if (index_maps.size() != equations.size())
+				return false;
+			std::vector<std::vector<_run>> runs(equations.size());
+			for (size_t k = 0; k < equations.size(); k++) {
+				if (!MakeRuns(index_maps[k], equations[k].GetNumParameters(), size, runs[k]))
+					return false;
+			}
+			dense_type normal = dense_type::Zero(size, size);
+			vector_type rhs = vector_type::Zero(size);
+			const size_t bands = std::max<size_t>(std::min(GetParallelism(), size), 1);
+			ParallelFor(0, bands, [&](const size_t band) {
+				const Eigen::Index begin = band * size / bands, end = (band + 1) * size / bands;
+				for (size_t k = 0; k < equations.size(); k++)
+					AddRuns(equations[k].normal_.unwrap(), equations[k].rhs_.unwrap(), runs[k], begin, end, normal, rhs);
+			}, bands);
+			stacked = NormalEquation<_T>(Matrix<_T>(std::move(normal)), Vector<_T>(std::move(rhs)));
+			return true;
+		}
+
+	private:
+		// A run of consecutive parameters mapped onto consecutive parameters
+		struct _run {
+			Eigen::Index local;
+			Eigen::Index global;
+			Eigen::Index size;
+		};
+
+		/// <summary> Split an index map into runs. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index_map">  The index map. </param>
+		/// <param name="local_size"> Number of the mapped parameters. </param>
+		/// <param name="size">		  Number of the parameters mapped onto. </param>
+		/// <param name="runs">		  [out] The runs. </param>
+		/// <returns> False if the index map has a wrong size or an index out of range. </returns>
+		static bool MakeRuns(const std::vector<size_t>& index_map, const size_t local_size, const size_t size,
+							 std::vector<_run>& runs) {
+			if (index_map.size() != local_size)
+				return false;
+			runs.clear();
+			for (size_t i = 0; i < index_map.size(); i++) {
+				if (index_map[i] >= size)
+					return false;
+				const Eigen::Index local = static_cast<Eigen::Index>(i), global = static_cast<Eigen::Index>(index_map[i]);
+				if (!runs.empty() && runs.back().global + runs.back().size == global)
+					runs.back().size++;
+				else
+					runs.push_back(_run{ local, global, 1 });
+			}
+			return true;
+		}
+
+		/// <summary> Add the rows of a mapped normal equation that fall in [begin, end). </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="normal">	  The mapped normal matrix. </param>
+		/// <param name="rhs">		  The mapped right-hand side. </param>
+		/// <param name="runs">		  The runs of the index map. </param>
+		/// <param name="begin">	  The first row to add. </param>
+		/// <param name="end">		  One past the last row to add. </param>
+		/// <param name="out_normal"> [in,out] The normal matrix added to. </param>
+		/// <param name="out_rhs">	  [in,out] The right-hand side added to. </param>
+		template<typename _Rhs>
+		static void AddRuns(const dense_type& normal, const vector_type& rhs, const std::vector<_run>& runs,
+							const Eigen::Index begin, const Eigen::Index end, dense_type& out_normal, _Rhs& out_rhs) {
+			for (size_t r = 0; r < runs.size(); r++) {
+				const Eigen::Index first = std::max(runs[r].global, begin), last = std::min(runs[r].global + runs[r].size, end);
+				if (first >= last)
+					continue;
+				const Eigen::Index local = runs[r].local + first - runs[r].global, rows = last - first;
+				out_rhs.segment(first, rows) += rhs.segment(local, rows);
+				for (size_t c = 0; c < runs.size(); c++)
+					out_normal.block(first, runs[c].global, rows, runs[c].size) += normal.block(local, runs[c].local, rows, runs[c].size);
+			}
+		}
+
+		// N
+		Matrix<_T> normal_;
+		// b
+		Vector<_T> rhs_;
+	};
+
+	/// <summary>
+	/// 	<para> Elimination of local (arc) parameters from the normal equations of several arcs by the
+	/// 	Schur complement, e.g. the initial states and empirical accelerations of each arc in a
+	/// 	multi-arc orbit determination. </para>
+	/// 	<para> The parameters of an arc are ordered local first, the trailing global parameters are
+	/// 	the same for every arc. The reduced normal equation of the global parameters is </para>
+	/// 	<code> sum (N_gg - N_gl N_ll^-1 N_lg) x_g = sum (b_g - N_gl N_ll^-1 b_l) </code>
+	/// 	<para> Arcs are eliminated in parallel, the full system is never formed. After solving for
+	/// 	the global parameters, <c>BackSubstitute</c> recovers the local ones. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T = double>
+	class SchurElimination {
+	public:
+		typedef typename Matrix<_T>::base_type dense_type;
+		typedef typename Vector<_T>::base_type vector_type;
+
+	public:
+		/// <summary> Eliminate the local parameters of the arcs. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="arcs">		   The normal equations of the arcs. </param>
+		/// <param name="local_sizes"> Number of the leading local parameters of each arc. </param>
+		/// <returns>
+		/// 	False if the arcs do not share the number of global parameters, or the local normal
+		/// 	matrix of an arc is not positive definite.
+		/// </returns>
+		bool Eliminate(const std::vector<NormalEquation<_T>>& arcs, const std::vector<size_t>& local_sizes) {
+			NUDTTK_INSTRUMENT_SCOPE("SchurElimination::Eliminate");
+			const size_t count = arcs.size();
+			arcs_.assign(count, _arc());
+			reduced_ = NormalEquation<_T>();
+			if (count == 0 || local_sizes.size() != count || arcs[0].GetNumParameters() < local_sizes[0])
+				return false;
+			const size_t global = arcs[0].GetNumParameters() - local_sizes[0];
+			for (size_t i = 0; i < count; i++) {
+				if (arcs[i].GetNumParameters() != local_sizes[i] + global)
+					return false;
+			}
+
+			// Contiguous chunks of arcs are summed by one worker each, then the chunks in order, so the
+			// sum does not depend on the scheduling
+			const size_t chunks = std::min(GetParallelism(), count);
+			std::vector<dense_type> normal_sums(chunks, dense_type::Zero(global, global));
+			std::vector<vector_type> rhs_sums(chunks, vector_type::Zero(global));
+			std::vector<char> eliminated(count, 0);
+			ParallelFor(0, chunks, [&](const size_t chunk) {
+				for (size_t i = chunk * count / chunks; i < (chunk + 1) * count / chunks; i++)
+					eliminated[i] = EliminateArc(arcs[i], local_sizes[i], arcs_[i], normal_sums[chunk], rhs_sums[chunk]);
+			}, chunks);
+			for (size_t i = 0; i < count; i++) {
+				if (!eliminated[i]) {
+					arcs_.clear();
+					return false;
+				}
+			}
+
+			for (size_t chunk = 1; chunk < chunks; chunk++) {
+				normal_sums[0] += normal_sums[chunk];
+				rhs_sums[0] += rhs_sums[chunk];
+			}
+			reduced_ = NormalEquation<_T>(Matrix<_T>(std::move(normal_sums[0])), Vector<_T>(std::move(rhs_sums[0])));
+			return true;
+		}
+
+		/// <summary> Gets the reduced normal equation of the global parameters. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The reduced normal equation, empty before a successful elimination. </returns>
+		const NormalEquation<_T>& GetReduced() const _NOEXCEPT {
+			return reduced_;
+		}
+
+		/// <summary> Recover the local parameters of every arc, <c>x_l = N_ll^-1 (b_l - N_lg x_g)</c>, in parallel. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="global_solution">  The solution of the reduced normal equation. </param>
+		/// <param name="local_solutions"> [out] The local parameters of each arc. </param>
+		/// <returns> False if nothing is eliminated or the global solution has a wrong size. </returns>
+		bool BackSubstitute(const Vector<_T>& global_solution, std::vector<Vector<_T>>& local_solutions) const {
+			NUDTTK_INSTRUMENT_SCOPE("SchurElimination::BackSubstitute");
+			if (arcs_.empty() || global_solution.GetSize() != reduced_.GetNumParameters())
+				return false;
+			local_solutions.assign(arcs_.size(), Vector<_T>());
+			ParallelFor(0, arcs_.size(), [&](const size_t i) {
+				local_solutions[i] = BackSubstituteArc(arcs_[i], global_solution.unwrap());
+			});
+			return true;
+		}
+
+		/// <summary> Recover the local parameters of an arc, <c>x_l = N_ll^-1 (b_l - N_lg x_g)</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index">		   Zero-based index of the arc. </param>
+		/// <param name="global_solution"> The solution of the reduced normal equation. </param>
+		/// <returns> The local parameters of the arc. </returns>
+		Vector<_T> BackSubstitute(const size_t index, const Vector<_T>& global_solution) const {
+			return BackSubstituteArc(arcs_[index], global_solution.unwrap());
+		}
+
+	private:
+		// What an arc keeps for the back substitution
+		struct _arc {
+			dense_type solved_coupling;		// N_ll^-1 N_lg
+			vector_type solved_rhs;			// N_ll^-1 b_l
+		};
+
+		/// <summary> Eliminate the local parameters of an arc and add its reduced normal equation. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="equation">	  The normal equation of the arc. </param>
+		/// <param name="local">	  Number of the local parameters. </param>
+		/// <param name="arc">		  [out] What is kept for the back substitution. </param>
+		/// <param name="normal_sum"> [in,out] Sum of the reduced normal matrices. </param>
+		/// <param name="rhs_sum">	  [in,out] Sum of the reduced right-hand sides. </param>
+		/// <returns> False if the local normal matrix is not positive definite. </returns>
+		static bool EliminateArc(const NormalEquation<_T>& equation, const size_t local, _arc& arc,
+								 dense_type& normal_sum, vector_type& rhs_sum) {
+			const dense_type& normal = equation.GetNormalMatrix().unwrap();
+			const vector_type& rhs = equation.GetRightHandSide().unwrap();
+			const Eigen::Index size = static_cast<Eigen::Index>(local), global = normal_sum.rows();
+			const Eigen::LLT<dense_type> llt(normal.topLeftCorner(size, size));
+			if (llt.info() != Eigen::Success)
+				return false;
+			arc.solved_coupling = llt.solve(normal.topRightCorner(size, global));
+			arc.solved_rhs = llt.solve(rhs.head(size));
+			// Member call syntax keeps the expression operators of this namespace out of overload resolution
+			normal_sum += normal.bottomRightCorner(global, global);
+			normal_sum.noalias() -= normal.bottomLeftCorner(global, size).operator*(arc.solved_coupling);
+			rhs_sum += rhs.tail(global);
+			rhs_sum.noalias() -= normal.bottomLeftCorner(global, size).operator*(arc.solved_rhs);
+			return true;
+		}
+
+		static Vector<_T> BackSubstituteArc(const _arc& arc, const vector_type& global_solution) {
+			vector_type local = arc.solved_rhs;
+			local.noalias() -= arc.solved_coupling.operator*(global_solution);
+			return Vector<_T>(std::move(local));
+		}
+
+		// Kept per arc, the size of the local by the global parameters
+		std::vector<_arc> arcs_;
+		// The reduced normal equation of the global parameters
+		NormalEquation<_T> reduced_;
+	};
+}
+
+#endif	// !_NUDTTK_MATH_NORMAL_EQUATION_TR_
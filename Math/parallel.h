@@ -0,0 +1,85 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_PARALLEL_TR_
+#define _NUDTTK_MATH_PARALLEL_TR_
+
+#include "common.h"
+
+#include <cstddef>
+#include <algorithm>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#endif	// __cplusplus >= 201103L
+
+namespace NUDTTK {
+
+	/// <summary> Gets the default number of worker threads, the number of hardware threads. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <returns> The number of worker threads, 1 without C++11. </returns>
+	inline size_t GetParallelism() _NOEXCEPT {
+#if __cplusplus >= 201103L
+		const size_t hardware = static_cast<size_t>(std::thread::hardware_concurrency());
+		return hardware > 0 ? hardware : 1;
+#else
+		return 1;
+#endif	// __cplusplus >= 201103L
+	}
+
+	/// <summary>
+	/// 	<para> Run <c>task(index)</c> for every index in [begin, end) on worker threads. </para>
+	/// 	<para> Indices are handed out one at a time, so tasks of uneven cost, e.g. blocks of
+	/// 	different sizes, are balanced. Runs inline for a single index or worker, and without C++11. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Task"> Type of the task, callable with a <c>size_t</c>. </typeparam>
+	/// <param name="begin">   The first index. </param>
+	/// <param name="end">	   One past the last index. </param>
+	/// <param name="task">	   The task, MUST be safe to run concurrently for different indices. </param>
+	/// <param name="workers"> (Optional) Number of worker threads, 0 (default) for <c>GetParallelism()</c>. </param>
+	template<typename _Task>
+	void ParallelFor(const size_t begin, const size_t end, _Task task, size_t workers = 0) {
+		if (end <= begin)
+			return;
+		if (workers == 0)
+			workers = GetParallelism();
+		workers = std::min(workers, end - begin);
+		if (workers <= 1) {
+			for (size_t index = begin; index < end; index++)
+				task(index);
+			return;
+		}
+#if __cplusplus >= 201103L
+		std::atomic<size_t> next(begin);
+		auto work = [&]() {
+			for (size_t index = next++; index < end; index = next++)
+				task(index);
+		};
+		// The calling thread is a worker too
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1);
+		for (size_t worker = 1; worker < workers; worker++)
+			threads.emplace_back(work);
+		work();
+		for (std::thread& thread : threads)
+			thread.join();
+#endif	// __cplusplus >= 201103L
+	}
+
+#if __cplusplus >= 201103L
+	/// <summary> Run a task asynchronously on its own thread. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_Task"> Type of the task, callable without arguments. </typeparam>
+	/// <param name="task"> The task, it owns what it works on. </param>
+	/// <returns> The future of the result, <c>get()</c> waits for the task. </returns>
+	template<typename _Task>
+	auto Async(_Task task) -> std::future<decltype(task())> {
+		return std::async(std::launch::async, std::move(task));
+	}
+#endif	// __cplusplus >= 201103L
+}
+
+#endif	// !_NUDTTK_MATH_PARALLEL_TR_
@@ -0,0 +1,186 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_RANDOMIZED_SVD_TR_
+#define _NUDTTK_MATH_RANDOMIZED_SVD_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <algorithm>
+
+#if __cplusplus < 201103L
+#error You need to compile randomized SVD with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	/// <summary>
+	/// 	<para> Truncated singular value decomposition <c>A ~ U * diag(s) * V^T</c> of the k largest
+	/// 	singular values by a randomized range finder, for large matrices of which only the leading
+	/// 	singular triplets are needed, e.g. sensitivity matrices. </para>
+	/// 	<para> A is multiplied by k + oversampling Gaussian vectors, the samples are orthonormalized
+	/// 	and refined by power iterations, and only the small projection <c>Q^T A</c> is decomposed. Every
+	/// 	product with A is a GEMM split into bands of rows over worker threads, so the cost is a few
+	/// 	passes over A instead of a full SVD. </para>
+	/// 	<para> The error estimate bounds the spectral norm of <c>A - U * diag(s) * V^T</c> with a
+	/// 	probability of 1 - 1e-10, from extra Gaussian probes taken in the first pass. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the t. </typeparam>
+	template<typename _T = double>
+	class RandomizedSvd {
+	public:
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, Eigen::Dynamic> dense_type;
+		typedef Eigen::Matrix<_T, Eigen::Dynamic, 1> vector_type;
+
+	public:
+		/// <summary> Decompose a matrix. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="a">				The matrix of any storage order. </param>
+		/// <param name="k">				Number of the singular values, at most the smaller size of a. </param>
+		/// <param name="oversampling">		(Optional) Number of the extra samples, 10 by default. </param>
+		/// <param name="power_iterations"> (Optional) Number of the power iterations, 2 by default,
+		/// 	more for slowly decaying singular values. </param>
+		/// <param name="seed">				(Optional) Seed of the Gaussian samples, the decomposition is
+		/// 	reproducible for a seed. </param>
+		template<int _Layout>
+		RandomizedSvd(const Matrix<_T, _Layout>& a, const size_t k, const size_t oversampling = 10,
+					  const size_t power_iterations = 2, const unsigned int seed = 5489u)
+			: valid_(false), error_(std::numeric_limits<_T>::quiet_NaN()) {
+			NUDTTK_INSTRUMENT_SCOPE("RandomizedSvd::Compute");
+			Compute(a.unwrap(), k, oversampling, power_iterations, seed);
+		}
+
+	public:
+		/// <summary> Whether it succeeded, false if k is 0 or too large, or a has non-finite values. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN bool IsValid() const _NOEXCEPT {
+			return valid_;
+		}
+
+		/// <summary> Gets the k largest singular values in descending order. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		const Vector<_T>& GetSingularValues() const _NOEXCEPT {
+			return singular_values_;
+		}
+
+		/// <summary> Gets the left singular vectors as the columns. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		const Matrix<_T>& GetU() const _NOEXCEPT {
+			return u_;
+		}
+
+		/// <summary> Gets the right singular vectors as the columns. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		const Matrix<_T>& GetV() const _NOEXCEPT {
+			return v_;
+		}
+
+		/// <summary> Gets the estimated bound of the spectral norm of the truncation error. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The error estimate, NaN if not valid. </returns>
+		_CONSTEXPR_FN _T GetErrorEstimate() const _NOEXCEPT {
+			return error_;
+		}
+
+	private:
+		// Number of the Gaussian probes of the error estimate, the bound fails with a probability of 10^-probes
+		enum { probes = 10, band_rows = 256 };
+
+		template<typename _Value>
+		void Compute(const _Value& a, const size_t k, const size_t oversampling, const size_t power_iterations,
+					 const unsigned int seed) {
+			const Eigen::Index size = std::min(a.rows(), a.cols());
+			if (k == 0 || k > static_cast<size_t>(size) || !a.allFinite())
+				return;
+			const Eigen::Index rank = static_cast<Eigen::Index>(k);
+			const Eigen::Index samples = std::min<Eigen::Index>(rank + static_cast<Eigen::Index>(oversampling), size);
+
+			// The probes share the pass over A with the samples
+			std::mt19937 engine(seed);
+			std::normal_distribution<_T> normal;
+			dense_type omega(a.cols(), samples + probes);
+			for (Eigen::Index j = 0; j < omega.cols(); j++) {
+				for (Eigen::Index i = 0; i < omega.rows(); i++)
+					omega(i, j) = normal(engine);
+			}
+			dense_type sample, q, z;
+			MultiplyBands(a, omega, sample);
+			q = sample.leftCols(samples);
+			dense_type probe = sample.rightCols(probes);
+			Orthonormalize(q);
+			for (size_t iteration = 0; iteration < power_iterations; iteration++) {
+				MultiplyBands(a.transpose(), q, z);
+				Orthonormalize(z);
+				MultiplyBands(a, z, q);
+				Orthonormalize(q);
+			}
+
+			// A ~ Q B with B^T = A^T Q, decomposed as B^T = U_b S V_b^T, so A ~ (Q V_b) S U_b^T
+			MultiplyBands(a.transpose(), q, z);
+			const unsigned int options = Eigen::ComputeThinU | Eigen::ComputeThinV;
+			dense_type left, right;
+			vector_type values;
+			if (samples > 16) {
+				const Eigen::BDCSVD<dense_type> svd(z, options);
+				values = svd.singularValues();
+				left = svd.matrixU();
+				right = svd.matrixV();
+			} else {
+				const Eigen::JacobiSVD<dense_type> svd(z, options);
+				values = svd.singularValues();
+				left = svd.matrixU();
+				right = svd.matrixV();
+			}
+			dense_type u;
+			MultiplyBands(q, dense_type(right.leftCols(rank)), u);
+
+			// Halko, Martinsson and Tropp (2011), Eq. 4.3 for the range, plus the first discarded singular value
+			probe.noalias() -= q * (q.transpose() * probe);
+			_T error = _T(10) * std::sqrt(_T(2) / _T(3.14159265358979323846)) * probe.colwise().norm().maxCoeff();
+			if (samples > rank)
+				error += values(rank);
+
+			valid_ = values.allFinite() && u.allFinite();
+			if (valid_) {
+				singular_values_ = Vector<_T>(vector_type(values.head(rank)));
+				u_ = Matrix<_T>(typename Matrix<_T>::base_type(u));
+				v_ = Matrix<_T>(typename Matrix<_T>::base_type(left.leftCols(rank)));
+				error_ = error;
+			}
+		}
+
+		/// <summary> Evaluate <c>out = lhs * rhs</c> as GEMMs of bands of rows on worker threads. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		template<typename _Lhs>
+		static void MultiplyBands(const _Lhs& lhs, const dense_type& rhs, dense_type& out) {
+			out.resize(lhs.rows(), rhs.cols());
+			const size_t rows = static_cast<size_t>(lhs.rows());
+			const size_t bands = std::max<size_t>(std::min(GetParallelism(), rows / band_rows), 1);
+			ParallelFor(0, bands, [&](const size_t band) {
+				const Eigen::Index begin = band * rows / bands, end = (band + 1) * rows / bands;
+				out.middleRows(begin, end - begin).noalias() = lhs.middleRows(begin, end - begin) * rhs;
+			}, bands);
+		}
+
+		/// <summary> Replace the columns by an orthonormal basis of their span, the thin Q of QR. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		static void Orthonormalize(dense_type& value) {
+			const Eigen::HouseholderQR<dense_type> qr(value);
+			value = qr.householderQ().operator*(dense_type::Identity(value.rows(), value.cols()));
+		}
+
+		bool valid_;
+		_T error_;
+		Vector<_T> singular_values_;
+		Matrix<_T> u_, v_;
+	};
+}
+
+#endif	// !_NUDTTK_MATH_RANDOMIZED_SVD_TR_
@@ -0,0 +1,302 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_RESULT_CACHE_TR_
+#define _NUDTTK_MATH_RESULT_CACHE_TR_
+
+#include "common.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <typeinfo>
+
+// The result cache is runtime optional and disabled by default, define NUDTTK_RESULT_CACHE_BUDGET
+// (bytes) to enable it from the start, or call ResultCache::SetBudget. It needs C++11 like lazy
+// evaluation, without it every query misses.
+#ifndef NUDTTK_RESULT_CACHE_BUDGET
+#define NUDTTK_RESULT_CACHE_BUDGET 0
+#endif	// NUDTTK_RESULT_CACHE_BUDGET
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <any>
+#else	// __cplusplus < 201703L
+#include <boost/any.hpp>
+#endif	// __cplusplus >= 201703L
+#endif	// __cplusplus >= 201103L
+
+namespace NUDTTK {
+	namespace ResultCache {
+
+		/// <summary> Usage of the result cache. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		struct Usage {
+			unsigned long long hits;		// Number of results found
+			unsigned long long misses;		// Number of results not found, computed by the caller
+			unsigned long long evictions;	// Number of least recently used results dropped for the budget
+			size_t entries;					// Number of cached results
+			size_t bytes;					// Bytes held by the cached results and their keys
+			size_t budget;					// Most bytes held, 0 when disabled
+		};
+	}
+
+#if __cplusplus >= 201103L
+	/// <summary> Fast 64-bit hash of raw content, four independent lanes of 8-byte words. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="data">  The content. </param>
+	/// <param name="bytes"> Number of bytes of the content. </param>
+	/// <returns> The hash. </returns>
+	inline std::uint64_t _content_hash(const void* data, const size_t bytes) _NOEXCEPT {
+		static const std::uint64_t prime1 = 0x9E3779B185EBCA87ULL, prime2 = 0xC2B2AE3D27D4EB4FULL;
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		std::uint64_t lanes[4] = { prime1, prime2, ~prime1, ~prime2 };
+		size_t offset = 0;
+		for (; offset + 32 <= bytes; offset += 32) {
+			for (int lane = 0; lane < 4; lane++) {
+				std::uint64_t word;
+				std::memcpy(&word, p + offset + 8 * lane, 8);
+				lanes[lane] += word * prime2;
+				lanes[lane] = ((lanes[lane] << 31) | (lanes[lane] >> 33)) * prime1;
+			}
+		}
+		std::uint64_t hash = static_cast<std::uint64_t>(bytes) * prime1;
+		for (int lane = 0; lane < 4; lane++)
+			hash = ((hash ^ lanes[lane]) * prime2) + prime1;
+		for (; offset < bytes; offset++)
+			hash = (hash ^ p[offset]) * prime1;
+		// Avalanche, the low bits choose the bucket
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		return hash;
+	}
+
+	/// <summary> Content of a matrix a cached result is keyed by. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	struct _result_key {
+		const std::type_info* type;		// Type of the matrix, e.g. its scalar type and storage order
+		const void* data;				// Values, contiguous
+		size_t bytes;					// Bytes of the values
+		size_t rows, cols;
+		std::uint64_t hash;				// Hash of the values, see _content_hash
+	};
+
+	/// <summary>
+	/// 	<para> Process-wide cache of expensive results by the content of the matrix and the operation,
+	/// 	shared by every instance and thread, under a memory budget with LRU eviction. </para>
+	/// 	<para> A hit compares the whole content with the cached copy, so hash collisions never return
+	/// 	a wrong result. Results are computed outside the lock, two threads missing the same result at
+	/// 	once both compute it and the first stored is kept. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	class _result_cache {
+	public:
+		static _result_cache& Instance() _NOEXCEPT {
+			static _result_cache instance;
+			return instance;
+		}
+
+		bool Enabled() const _NOEXCEPT {
+			return budget_.load(std::memory_order_relaxed) > 0;
+		}
+
+		/// <summary> Find a result and mark it as the most recently used. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="key">		 The content. </param>
+		/// <param name="operation"> The operation, e.g. "inverse_value". </param>
+		/// <param name="variant">	 The variant of the operation, e.g. the structure it is routed by. </param>
+		/// <param name="cached">	 [out] The cached result. </param>
+		/// <returns> True if found. </returns>
+		template<typename _Cached>
+		bool Find(const _result_key& key, const char* operation, const long variant, _Cached& cached) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			const auto range = index_.equal_range(key.hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				const _entry& entry = *it->second;
+				if (!entry.Matches(key, operation, variant))
+					continue;
+#ifdef _OPTIONAL_
+				const _Cached* value = std::any_cast<_Cached>(&entry.value);
+#else
+				const _Cached* value = boost::any_cast<_Cached>(&entry.value);
+#endif	// _OPTIONAL_
+				if (value == nullptr)
+					continue;
+				cached = *value;
+				lru_.splice(lru_.begin(), lru_, it->second);
+				hits_++;
+				return true;
+			}
+			misses_++;
+			return false;
+		}
+
+		/// <summary> Store a result as the most recently used, evicting the least recently used ones. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="key">		 The content, copied to verify hits. </param>
+		/// <param name="operation"> The operation, a string literal. </param>
+		/// <param name="variant">	 The variant of the operation. </param>
+		/// <param name="cached">	 The result. </param>
+		/// <param name="bytes">	 Bytes held by the result, e.g. of its matrices. </param>
+		template<typename _Cached>
+		void Store(const _result_key& key, const char* operation, const long variant, const _Cached& cached, const size_t bytes) {
+			const size_t total = key.bytes + bytes + sizeof(_entry);
+			if (total > budget_.load(std::memory_order_relaxed))
+				return;
+			// The copies are made outside the lock, the node is spliced in
+			std::list<_entry> node(1);
+			_entry& entry = node.front();
+			entry.type = key.type;
+			entry.operation = operation;
+			entry.variant = variant;
+			entry.rows = key.rows;
+			entry.cols = key.cols;
+			entry.hash = key.hash;
+			entry.content.assign(static_cast<const unsigned char*>(key.data),
+								 static_cast<const unsigned char*>(key.data) + key.bytes);
+			entry.value = cached;
+			entry.bytes = total;
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			const auto range = index_.equal_range(key.hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				if (it->second->Matches(key, operation, variant))
+					return;
+			}
+			lru_.splice(lru_.begin(), node);
+			index_.insert(std::make_pair(key.hash, lru_.begin()));
+			bytes_ += total;
+			Evict(budget_.load(std::memory_order_relaxed));
+		}
+
+		void SetBudget(const size_t budget) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			budget_.store(budget, std::memory_order_relaxed);
+			Evict(budget);
+		}
+
+		void Clear() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			index_.clear();
+			lru_.clear();
+			bytes_ = 0;
+			hits_ = misses_ = evictions_ = 0;
+		}
+
+		ResultCache::Usage GetUsage() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			const ResultCache::Usage usage = { hits_, misses_, evictions_, lru_.size(), bytes_,
+											   budget_.load(std::memory_order_relaxed) };
+			return usage;
+		}
+
+	private:
+		struct _entry {
+			const std::type_info* type;
+			std::string operation;
+			long variant;
+			size_t rows, cols;
+			std::uint64_t hash;
+			std::vector<unsigned char> content;
+#ifdef _OPTIONAL_
+			std::any value;
+#else
+			boost::any value;
+#endif	// _OPTIONAL_
+			size_t bytes;
+
+			bool Matches(const _result_key& key, const char* other_operation, const long other_variant) const {
+				return hash == key.hash && rows == key.rows && cols == key.cols && variant == other_variant &&
+					*type == *key.type && operation == other_operation && content.size() == key.bytes &&
+					std::memcmp(content.data(), key.data, key.bytes) == 0;
+			}
+		};
+
+		typedef std::list<_entry> lru_t;
+
+		_result_cache()
+			: budget_(NUDTTK_RESULT_CACHE_BUDGET), bytes_(0), hits_(0), misses_(0), evictions_(0) {}
+
+		void Evict(const size_t budget) {
+			while (bytes_ > budget && !lru_.empty()) {
+				const lru_t::iterator last = std::prev(lru_.end());
+				const auto range = index_.equal_range(last->hash);
+				for (auto it = range.first; it != range.second; ++it) {
+					if (it->second == last) {
+						index_.erase(it);
+						break;
+					}
+				}
+				bytes_ -= last->bytes;
+				lru_.erase(last);
+				evictions_++;
+			}
+		}
+
+		std::mutex mutex_;
+		lru_t lru_;							// Most recently used first
+		std::unordered_multimap<std::uint64_t, lru_t::iterator> index_;
+		std::atomic<size_t> budget_;
+		size_t bytes_;
+		unsigned long long hits_, misses_, evictions_;
+	};
+#endif	// __cplusplus >= 201103L
+
+	namespace ResultCache {
+
+		/// <summary>
+		/// 	<para> Set the memory budget of the result cache, 0 disables it. </para>
+		/// 	<para> Inverses, determinants and factorizations are then looked up by the content of the
+		/// 	matrix before they are computed, so identical matrices built again, e.g. the design matrix
+		/// 	of identically spaced windows, are factorized once across instances and threads. The least
+		/// 	recently used results are evicted to keep the cache within the budget. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="bytes"> The budget in bytes, counting the results and a copy of each matrix. </param>
+		inline void SetBudget(const size_t bytes) {
+#if __cplusplus >= 201103L
+			_result_cache::Instance().SetBudget(bytes);
+#else
+			(void)bytes;
+#endif	// __cplusplus >= 201103L
+		}
+
+		/// <summary> Whether the result cache is enabled, i.e. has a budget. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline bool Enabled() _NOEXCEPT {
+#if __cplusplus >= 201103L
+			return _result_cache::Instance().Enabled();
+#else
+			return false;
+#endif	// __cplusplus >= 201103L
+		}
+
+		/// <summary> Drop every cached result and reset the counters, the budget is kept. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline void Clear() {
+#if __cplusplus >= 201103L
+			_result_cache::Instance().Clear();
+#endif	// __cplusplus >= 201103L
+		}
+
+		/// <summary> Gets the usage of the result cache. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		inline Usage GetUsage() {
+#if __cplusplus >= 201103L
+			return _result_cache::Instance().GetUsage();
+#else
+			const Usage usage = { 0, 0, 0, 0, 0, 0 };
+			return usage;
+#endif	// __cplusplus >= 201103L
+		}
+	}
+}
+
+#endif	// !_NUDTTK_MATH_RESULT_CACHE_TR_
@@ -0,0 +1,377 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_STATISTICS_TR_
+#define _NUDTTK_MATH_STATISTICS_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "vector.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if __cplusplus < 201103L
+#error You need to compile statistics with compilers support C++ 11.
+#endif	// __cplusplus < 201103L
+
+namespace NUDTTK {
+
+	namespace Stat {
+		/// <summary> Statistics computed by a reduction, combined with <c>|</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		enum Flags {
+			Min = 0x001,			// Minimum and its coordinates
+			Max = 0x002,			// Maximum and its coordinates
+			Sum = 0x004,			// Sum
+			Mean = 0x008,			// Mean
+			Variance = 0x010,		// Sample variance, divided by count - 1
+			Norm1 = 0x020,			// Sum of absolute values
+			Norm2 = 0x040,			// Square root of the sum of squares
+			NormInf = 0x080,		// Maximum absolute value
+			NaNCount = 0x100,		// Number of NaN values
+			All = 0x1ff
+		};
+	}
+
+	/// <summary>
+	/// 	<para> Statistics of a matrix, a row, a column or an array, see <c>Reduce</c>. </para>
+	/// 	<para> Statistics not requested are 0. NaN values propagate into the other statistics,
+	/// 	count them to tell. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the values. </typeparam>
+	template<typename _T>
+	struct Statistics {
+		size_t count;				// Number of values
+		_T minimum;					// Minimum, the first one if repeated, NaN if empty
+		size_t min_row, min_col;	// Coordinates of the minimum in the matrix, 0 if empty
+		_T maximum;					// Maximum, the first one if repeated, NaN if empty
+		size_t max_row, max_col;	// Coordinates of the maximum in the matrix, 0 if empty
+		_T sum;
+		_T mean;					// NaN if empty
+		_T variance;				// Sample variance, 0 for a single value
+		_T norm1;
+		_T norm2;
+		_T norm_inf;
+		size_t nan_count;
+	};
+
+	/// <summary>
+	/// 	<para> Partial statistics of values in storage, merged in storage order. </para>
+	/// 	<para> Locations are offsets in the storage, the variance is kept as the sum of squared
+	/// 	deviations and merged by the pairwise update of Chan et al. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T"> Type of the values. </typeparam>
+	template<typename _T>
+	struct _statistics_accumulator {
+		typedef Eigen::Array<_T, Eigen::Dynamic, 1> array_type;
+
+		enum {
+			chunk_size = 4096,			// Values of a contiguous chunk are reduced while they are in cache
+			parallel_size = 1 << 16		// Reductions of fewer values run on the calling thread
+		};
+
+		size_t count = 0;
+		_T minimum = _T(0), maximum = _T(0);
+		size_t min_offset = 0, max_offset = 0;
+		_T sum = _T(0), m2 = _T(0), norm1 = _T(0), squares = _T(0), norm_inf = _T(0);
+		size_t nan_count = 0;
+
+		/// <summary> Merge statistics of the values following these. </summary>
+		void Merge(const _statistics_accumulator& other) {
+			if (other.count == 0)
+				return;
+			if (count == 0) {
+				*this = other;
+				return;
+			}
+			if (other.minimum < minimum) {
+				minimum = other.minimum;
+				min_offset = other.min_offset;
+			}
+			if (other.maximum > maximum) {
+				maximum = other.maximum;
+				max_offset = other.max_offset;
+			}
+			const _T n_a = static_cast<_T>(count), n_b = static_cast<_T>(other.count);
+			const _T delta = other.sum / n_b - sum / n_a;
+			m2 += other.m2 + delta * delta * n_a * n_b / (n_a + n_b);
+			sum += other.sum;
+			norm1 += other.norm1;
+			squares += other.squares;
+			norm_inf = std::max(norm_inf, other.norm_inf);
+			nan_count += other.nan_count;
+			count += other.count;
+		}
+
+		/// <summary> Statistics of contiguous values, chunk by chunk. </summary>
+		/// <param name="data">   The values. </param>
+		/// <param name="size">   Number of the values. </param>
+		/// <param name="offset"> Offset of the first value in the storage. </param>
+		/// <param name="flags">  The statistics, see <c>Stat::Flags</c>. </param>
+		static _statistics_accumulator Reduce(const _T* data, const size_t size, const size_t offset, const int flags) {
+			_statistics_accumulator result;
+			for (size_t begin = 0; begin < size; begin += chunk_size) {
+				const size_t length = std::min<size_t>(chunk_size, size - begin);
+				const Eigen::Map<const array_type> x(data + begin, static_cast<Eigen::Index>(length));
+				_statistics_accumulator chunk;
+				chunk.count = length;
+				Eigen::Index index = 0;
+				if (flags & Stat::Min) {
+					chunk.minimum = x.minCoeff(&index);
+					chunk.min_offset = offset + begin + static_cast<size_t>(index);
+				}
+				if (flags & Stat::Max) {
+					chunk.maximum = x.maxCoeff(&index);
+					chunk.max_offset = offset + begin + static_cast<size_t>(index);
+				}
+				if (flags & (Stat::Sum | Stat::Mean | Stat::Variance))
+					chunk.sum = x.sum();
+				if (flags & Stat::Variance)
+					chunk.m2 = (x - chunk.sum / static_cast<_T>(length)).square().sum();
+				if (flags & Stat::Norm1)
+					chunk.norm1 = x.abs().sum();
+				if (flags & Stat::Norm2)
+					chunk.squares = x.square().sum();
+				if (flags & Stat::NormInf)
+					chunk.norm_inf = x.abs().maxCoeff();
+				if (flags & Stat::NaNCount)
+					chunk.nan_count = static_cast<size_t>((x != x).count());
+				result.Merge(chunk);
+			}
+			return result;
+		}
+
+		/// <summary> Statistics of contiguous values, ranges of chunks in parallel for many values. </summary>
+		static _statistics_accumulator ReduceParallel(const _T* data, const size_t size, const int flags) {
+			const size_t chunks = (size + chunk_size - 1) / chunk_size;
+			const size_t tasks = size < parallel_size ? 1 : std::min<size_t>(chunks, 4 * GetParallelism());
+			std::vector<_statistics_accumulator> partial(tasks);
+			ParallelFor(0, tasks, [&](const size_t task) {
+				const size_t begin = chunks * task / tasks * chunk_size;
+				const size_t end = std::min(size, chunks * (task + 1) / tasks * chunk_size);
+				partial[task] = Reduce(data + begin, end - begin, begin, flags);
+			});
+			_statistics_accumulator result;
+			for (size_t task = 0; task < tasks; task++)
+				result.Merge(partial[task]);
+			return result;
+		}
+
+		/// <summary>
+		/// 	<para> Statistics at positions [begin, end) across lanes, the lane j of size values is
+		/// 	stored from <c>data + j * size</c>, e.g. the columns of a row-major matrix across its rows. </para>
+		/// 	<para> Each lane updates arrays of the positions, so every access is contiguous. </para>
+		/// </summary>
+		static void ReduceAcross(const _T* data, const size_t lanes, const size_t size,
+								 const size_t begin, const size_t end, const int flags,
+								 std::vector<_statistics_accumulator>& result) {
+			typedef Eigen::Array<Eigen::Index, Eigen::Dynamic, 1> index_type;
+			if (lanes == 0)
+				return;
+			const Eigen::Index positions = static_cast<Eigen::Index>(end - begin);
+			array_type minimum, maximum, sum, mean, m2, norm1, squares, norm_inf, nan_count;
+			index_type min_lane = index_type::Zero(positions), max_lane = index_type::Zero(positions);
+			for (size_t lane = 0; lane < lanes; lane++) {
+				const Eigen::Map<const array_type> x(data + lane * size + begin, positions);
+				if (lane == 0) {
+					minimum = maximum = x;
+					sum = mean = x;
+					m2 = array_type::Zero(positions);
+					norm1 = norm_inf = x.abs();
+					squares = x.square();
+					nan_count = (x != x).template cast<_T>();
+					continue;
+				}
+				const index_type current = index_type::Constant(positions, static_cast<Eigen::Index>(lane));
+				if (flags & Stat::Min) {
+					min_lane = (x < minimum).select(current, min_lane);
+					minimum = minimum.min(x);
+				}
+				if (flags & Stat::Max) {
+					max_lane = (x > maximum).select(current, max_lane);
+					maximum = maximum.max(x);
+				}
+				if (flags & (Stat::Sum | Stat::Mean))
+					sum += x;
+				if (flags & Stat::Variance) {
+					// Welford's update, the deviation from the previous mean first
+					const array_type delta = x - mean;
+					mean += delta / static_cast<_T>(lane + 1);
+					m2 += delta * (x - mean);
+				}
+				if (flags & Stat::Norm1)
+					norm1 += x.abs();
+				if (flags & Stat::Norm2)
+					squares += x.square();
+				if (flags & Stat::NormInf)
+					norm_inf = norm_inf.max(x.abs());
+				if (flags & Stat::NaNCount)
+					nan_count += (x != x).template cast<_T>();
+			}
+			for (Eigen::Index i = 0; i < positions; i++) {
+				_statistics_accumulator& position = result[begin + i];
+				position.count = lanes;
+				position.minimum = minimum(i);
+				position.min_offset = static_cast<size_t>(min_lane(i)) * size + begin + i;
+				position.maximum = maximum(i);
+				position.max_offset = static_cast<size_t>(max_lane(i)) * size + begin + i;
+				position.sum = sum(i);
+				position.m2 = m2(i);
+				position.norm1 = norm1(i);
+				position.squares = squares(i);
+				position.norm_inf = norm_inf(i);
+				position.nan_count = static_cast<size_t>(nan_count(i));
+			}
+		}
+
+		/// <summary> Statistics of each lane or each position across lanes, see <c>ReduceAcross</c>. </summary>
+		/// <param name="data">	  The values, lanes stored one after another. </param>
+		/// <param name="lanes">  Number of the lanes. </param>
+		/// <param name="size">	  Number of the values of a lane. </param>
+		/// <param name="across"> True for the statistics of each position, false for each lane. </param>
+		/// <param name="flags">  The statistics, see <c>Stat::Flags</c>. </param>
+		static std::vector<_statistics_accumulator> ReduceLanes(const _T* data, const size_t lanes, const size_t size,
+																const bool across, const int flags) {
+			const size_t workers = lanes * size < parallel_size ? 1 : 0;
+			std::vector<_statistics_accumulator> result(across ? size : lanes);
+			if (!across) {
+				ParallelFor(0, lanes, [&](const size_t lane) {
+					result[lane] = Reduce(data + lane * size, size, lane * size, flags);
+				}, workers);
+				return result;
+			}
+			// Blocks of positions keep the arrays in cache
+			const size_t block = chunk_size / 4;
+			ParallelFor(0, (size + block - 1) / block, [&](const size_t index) {
+				ReduceAcross(data, lanes, size, index * block, std::min<size_t>(size, (index + 1) * block), flags, result);
+			}, workers);
+			return result;
+		}
+
+		/// <summary> Statistics with the coordinates of a storage of rows by columns. </summary>
+		Statistics<_T> ToStatistics(const int flags, const size_t rows, const size_t cols, const bool row_major) const {
+			const _T nan = std::numeric_limits<_T>::quiet_NaN();
+			Statistics<_T> result = {};
+			result.count = count;
+			// Without values there are no coordinates, and the storage may have no rows or columns
+			if (flags & Stat::Min) {
+				result.minimum = count > 0 ? minimum : nan;
+				if (count > 0) {
+					result.min_row = row_major ? min_offset / cols : min_offset % rows;
+					result.min_col = row_major ? min_offset % cols : min_offset / rows;
+				}
+			}
+			if (flags & Stat::Max) {
+				result.maximum = count > 0 ? maximum : nan;
+				if (count > 0) {
+					result.max_row = row_major ? max_offset / cols : max_offset % rows;
+					result.max_col = row_major ? max_offset % cols : max_offset / rows;
+				}
+			}
+			if (flags & Stat::Sum)
+				result.sum = sum;
+			if (flags & Stat::Mean)
+				result.mean = count > 0 ? sum / static_cast<_T>(count) : nan;
+			if (flags & Stat::Variance)
+				result.variance = count > 1 ? m2 / static_cast<_T>(count - 1) : _T(0);
+			if (flags & Stat::Norm1)
+				result.norm1 = norm1;
+			if (flags & Stat::Norm2)
+				result.norm2 = std::sqrt(squares);
+			if (flags & Stat::NormInf)
+				result.norm_inf = norm_inf;
+			if (flags & Stat::NaNCount)
+				result.nan_count = nan_count;
+			return result;
+		}
+	};
+
+	/// <summary>
+	/// 	<para> Statistics of all values of a matrix in a single pass, e.g.
+	/// 	<c>Reduce(A, Stat::Min | Stat::Max | Stat::Mean)</c>. </para>
+	/// 	<para> The storage is reduced in chunks by vectorized kernels while they are in cache,
+	/// 	chunks of a large matrix are reduced in parallel and merged in order. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="matrix"> The matrix. </param>
+	/// <param name="flags">  (Optional) The statistics, see <c>Stat::Flags</c>, default all. </param>
+	/// <returns> The statistics. </returns>
+	template<typename _T, int _Layout>
+	Statistics<_T> Reduce(const Matrix<_T, _Layout>& matrix, const int flags = Stat::All) {
+		NUDTTK_INSTRUMENT_SCOPE("Matrix::Reduce");
+		const size_t rows = matrix.GetNumRows(), cols = matrix.GetNumColumns();
+		return _statistics_accumulator<_T>::ReduceParallel(matrix.unwrap().data(), rows * cols, flags)
+			.ToStatistics(flags, rows, cols, _Layout == Eigen::RowMajor);
+	}
+
+	/// <summary> Statistics of the values of a vector in a single pass. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="vector"> The vector, the column of the coordinates is 0. </param>
+	/// <param name="flags">  (Optional) The statistics, see <c>Stat::Flags</c>, default all. </param>
+	/// <returns> The statistics. </returns>
+	template<typename _T, int _Size>
+	Statistics<_T> Reduce(const Vector<_T, _Size>& vector, const int flags = Stat::All) {
+		NUDTTK_INSTRUMENT_SCOPE("Vector::Reduce");
+		return _statistics_accumulator<_T>::ReduceParallel(vector.Data(), vector.GetSize(), flags)
+			.ToStatistics(flags, vector.GetSize(), 1, false);
+	}
+
+	/// <summary> Statistics of the values of an array in a single pass, without copying. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="data">  The values, the row of the coordinates is the index and the column is 0. </param>
+	/// <param name="size">  Number of the values. </param>
+	/// <param name="flags"> (Optional) The statistics, see <c>Stat::Flags</c>, default all. </param>
+	/// <returns> The statistics. </returns>
+	template<typename _T>
+	Statistics<_T> Reduce(const _T data[], const size_t size, const int flags = Stat::All) {
+		NUDTTK_INSTRUMENT_SCOPE("Vector::Reduce");
+		return _statistics_accumulator<_T>::ReduceParallel(data, size, flags).ToStatistics(flags, size, 1, false);
+	}
+
+	/// <summary>
+	/// 	<para> Statistics of each row of a matrix in a single pass. </para>
+	/// 	<para> Rows of a row-major matrix are reduced one by one, those of a column-major matrix
+	/// 	are reduced together while its columns are read. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="matrix"> The matrix. </param>
+	/// <param name="flags">  (Optional) The statistics, see <c>Stat::Flags</c>, default all. </param>
+	/// <returns> The statistics of the rows. </returns>
+	template<typename _T, int _Layout>
+	std::vector<Statistics<_T>> ReduceRows(const Matrix<_T, _Layout>& matrix, const int flags = Stat::All) {
+		NUDTTK_INSTRUMENT_SCOPE("Matrix::ReduceRows");
+		const size_t rows = matrix.GetNumRows(), cols = matrix.GetNumColumns();
+		const bool row_major = _Layout == Eigen::RowMajor;
+		const std::vector<_statistics_accumulator<_T>> partial = _statistics_accumulator<_T>::ReduceLanes(
+			matrix.unwrap().data(), row_major ? rows : cols, row_major ? cols : rows, !row_major, flags);
+		std::vector<Statistics<_T>> result(partial.size());
+		for (size_t i = 0; i < partial.size(); i++)
+			result[i] = partial[i].ToStatistics(flags, rows, cols, row_major);
+		return result;
+	}
+
+	/// <summary> Statistics of each column of a matrix in a single pass, see <c>ReduceRows</c>. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <param name="matrix"> The matrix. </param>
+	/// <param name="flags">  (Optional) The statistics, see <c>Stat::Flags</c>, default all. </param>
+	/// <returns> The statistics of the columns. </returns>
+	template<typename _T, int _Layout>
+	std::vector<Statistics<_T>> ReduceColumns(const Matrix<_T, _Layout>& matrix, const int flags = Stat::All) {
+		NUDTTK_INSTRUMENT_SCOPE("Matrix::ReduceColumns");
+		const size_t rows = matrix.GetNumRows(), cols = matrix.GetNumColumns();
+		const bool row_major = _Layout == Eigen::RowMajor;
+		const std::vector<_statistics_accumulator<_T>> partial = _statistics_accumulator<_T>::ReduceLanes(
+			matrix.unwrap().data(), row_major ? rows : cols, row_major ? cols : rows, row_major, flags);
+		std::vector<Statistics<_T>> result(partial.size());
+		for (size_t i = 0; i < partial.size(); i++)
+			result[i] = partial[i].ToStatistics(flags, rows, cols, row_major);
+		return result;
+	}
+}
+
+#endif	// !_NUDTTK_MATH_STATISTICS_TR_
@@ -0,0 +1,419 @@
+#pragma once
+
+#ifndef _NUDTTK_MATH_VECTOR_TR_
+#define _NUDTTK_MATH_VECTOR_TR_
+
+#include "common.h"
+#include "instrumentation.h"
+#include "matrix.h"
+
+namespace NUDTTK {
+
+	template<typename _T = double, int _Size = Eigen::Dynamic>
+	class Vector;
+
+	template<typename _T, int _Size>
+	struct _is_vector_operand<Vector<_T, _Size>> {
+		static const bool value = true;
+	};
+
+/// <summary> A macro that defines combine Implementation with binary Operation of Vector. </summary>
+/// <remarks> Blue Wing, 2026/10/19. </remarks>
+/// <param name="_impl">	 The implementation. </param>
+/// <param name="_operator"> The operator. </param>
+#define COMBINE_VECTOR_WITH_BINARY_OP(_impl, _operator)											\
+template<typename _T, int _Size>																\
+_CONSTEXPR_FN _impl<Vector<_T, _Size>, Vector<_T, _Size>>										\
+	operator _operator(const Vector<_T, _Size>& lhs, const Vector<_T, _Size>& rhs) {			\
+	return _impl<Vector<_T, _Size>, Vector<_T, _Size>>(lhs, rhs);								\
+}																								\
+template<typename _T, int _Size, typename _Lhs, typename _Rhs,									\
+	template<typename, typename> class _Impl>													\
+_CONSTEXPR_FN _impl<Vector<_T, _Size>, _Impl<_Lhs, _Rhs>>										\
+	operator _operator(const Vector<_T, _Size>& lhs, const _Impl<_Lhs, _Rhs>& rhs) {			\
+	return _impl<Vector<_T, _Size>, _Impl<_Lhs, _Rhs>>(lhs, rhs);								\
+}																								\
+template<typename _T, int _Size, typename _Lhs, typename _Rhs,									\
+	template<typename, typename> class _Impl>													\
+_CONSTEXPR_FN _impl<_Impl<_Lhs, _Rhs>, Vector<_T, _Size>>										\
+	operator _operator(const _Impl<_Lhs, _Rhs>& lhs, const Vector<_T, _Size>& rhs) {			\
+	return _impl<_Impl<_Lhs, _Rhs>, Vector<_T, _Size>>(lhs, rhs);								\
+}
+
+	// Support operator + - with Vector
+	COMBINE_VECTOR_WITH_BINARY_OP(add_op_impl, +);
+	COMBINE_VECTOR_WITH_BINARY_OP(sub_op_impl, -);
+
+	/// <summary> Matrix-vector product, evaluated by GEMV. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, int _Layout, int _Size>
+	_CONSTEXPR_FN mul_op_impl<Matrix<_T, _Layout>, Vector<_T, _Size>>
+		operator*(const Matrix<_T, _Layout>& lhs, const Vector<_T, _Size>& rhs) {
+		return mul_op_impl<Matrix<_T, _Layout>, Vector<_T, _Size>>(lhs, rhs);
+	}
+
+	/// <summary> Matrix expression-vector product, evaluated by GEMV. </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	template<typename _T, int _Size, typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+	_CONSTEXPR_FN mul_op_impl<_Impl<_Lhs, _Rhs>, Vector<_T, _Size>>
+		operator*(const _Impl<_Lhs, _Rhs>& lhs, const Vector<_T, _Size>& rhs) {
+		return mul_op_impl<_Impl<_Lhs, _Rhs>, Vector<_T, _Size>>(lhs, rhs);
+	}
+
+#ifdef _TYPE_TRAITS_
+	template<typename _Scalar, typename _T, int _Size,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+#else
+	template<typename _Scalar, typename _T, int _Size,
+		typename boost::enable_if_c<boost::is_arithmetic<_Scalar>::value, int>::type = 0>
+#endif // _TYPE_TRAITS_
+	_CONSTEXPR_FN mul_op_impl<_scalar_support<_Scalar>, Vector<_T, _Size>>
+		operator*(const _Scalar& lhs, const Vector<_T, _Size>& rhs) {
+		return mul_op_impl<_scalar_support<_Scalar>, Vector<_T, _Size>>(lhs, rhs);
+	}
+
+#ifdef _TYPE_TRAITS_
+	template<typename _Scalar, typename _T, int _Size,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+#else
+	template<typename _Scalar, typename _T, int _Size,
+		typename boost::enable_if_c<boost::is_arithmetic<_Scalar>::value, int>::type = 0>
+#endif // _TYPE_TRAITS_
+	_CONSTEXPR_FN mul_op_impl<Vector<_T, _Size>, _scalar_support<_Scalar>>
+		operator*(const Vector<_T, _Size>& lhs, const _Scalar& rhs) {
+		return mul_op_impl<Vector<_T, _Size>, _scalar_support<_Scalar>>(lhs, rhs);
+	}
+
+#ifdef _TYPE_TRAITS_
+	template<typename _Scalar, typename _T, int _Size,
+		typename std::enable_if<std::is_arithmetic<_Scalar>::value, int>::type = 0>
+#else
+	template<typename _Scalar, typename _T, int _Size,
+		typename boost::enable_if_c<boost::is_arithmetic<_Scalar>::value, int>::type = 0>
+#endif // _TYPE_TRAITS_
+	_CONSTEXPR_FN div_op_impl<Vector<_T, _Size>, _scalar_support<_Scalar>>
+		operator/(const Vector<_T, _Size>& lhs, const _Scalar& rhs) {
+		return div_op_impl<Vector<_T, _Size>, _scalar_support<_Scalar>>(lhs, rhs);
+	}
+
+	/// <summary>
+	/// 	<para> A column vector wrapper for Eigen, fixed size or dynamic. </para>
+	/// 	<para> Takes part in the expressions of Matrix, a matrix-vector product is evaluated by
+	/// 	GEMV instead of the general matrix product. Dot, axpy, norm and GEMV kernels are also
+	/// 	provided on <c>_T[]</c> arrays, which are mapped without copying. </para>
+	/// </summary>
+	/// <remarks> Blue Wing, 2026/10/19. </remarks>
+	/// <typeparam name="_T">    Type of the t. </typeparam>
+	/// <typeparam name="_Size"> Size of a fixed size vector, <c>Eigen::Dynamic</c> (default) otherwise. </typeparam>
+	template<typename _T, int _Size>
+	class Vector {
+	public:
+		typedef Eigen::Matrix<_T, _Size, 1> base_type;
+		CLS_BINARY_OP(Vector, base_type, value_, add_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, sub_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, mul_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, div_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, unary_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, cwise_mul_op_impl);
+		CLS_BINARY_OP(Vector, base_type, value_, cwise_div_op_impl);
+		CLS_UNWRAP(Vector, base_type, value_);
+
+	public:
+		/// <summary> Default constructor, a fixed size vector is zero. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		_CONSTEXPR_FN Vector() _NOEXCEPT {
+			if (_Size != Eigen::Dynamic)
+				value_.setZero();
+		}
+
+		/// <summary> Initialize zero Vector in size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size"> The size, MUST be <c>_Size</c> for a fixed size vector. </param>
+		explicit Vector(const size_t size) _NOEXCEPT
+			: value_(base_type::Zero(size)) {}
+
+		/// <summary> Initialize Vector in size with a copy of the values. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size">   The size, MUST be <c>_Size</c> for a fixed size vector. </param>
+		/// <param name="values"> The values, the caller MUST ensure there are <c>size</c> values. </param>
+		_CONSTEXPR_FN Vector(const size_t size, const _T values[])
+			: value_(Eigen::Map<const base_type>(values, size)) {}
+
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value. </param>
+		_CONSTEXPR_FN Vector(const base_type& value) _NOEXCEPT
+			: value_(value) {}
+
+#if __cplusplus >= 201103L
+		/// <summary> Constructor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="value"> The value to be MOVED. </param>
+		_CONSTEXPR_FN Vector(base_type&& value) _NOEXCEPT
+			: value_(std::move(value)) {}
+#endif	// __cplusplus >= 201103L
+
+	public:
+		/// <summary> Add other vector in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Vector instance. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator+=(const Vector<_T, _Size>& other) _NOEXCEPT {
+			value_ += other.value_;
+			return *this;
+		}
+
+		/// <summary> Subtract other vector in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Vector instance. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator-=(const Vector<_T, _Size>& other) _NOEXCEPT {
+			value_ -= other.value_;
+			return *this;
+		}
+
+		/// <summary> Multiply by scalar in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="scalar"> The scalar. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator*=(const _T& scalar) _NOEXCEPT {
+			value_ *= scalar;
+			return *this;
+		}
+
+		/// <summary> Divide by scalar in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="scalar"> The scalar. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator/=(const _T& scalar) _NOEXCEPT {
+			value_ /= scalar;
+			return *this;
+		}
+
+		/// <summary> Add expression in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The expression, may refer to this. </param>
+		/// <returns> This. </returns>
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator+=(const _Impl<_Lhs, _Rhs>& op) _NOEXCEPT {
+			// Evaluate before writing, the expression may refer to this
+			const base_type result = op.template unwrap<base_type>();
+			value_ += result;
+			return *this;
+		}
+
+		/// <summary> Subtract expression in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="op"> The expression, may refer to this. </param>
+		/// <returns> This. </returns>
+		template<typename _Lhs, typename _Rhs, template<typename, typename> class _Impl>
+		_CONSTEXPR_FN Vector<_T, _Size>& operator-=(const _Impl<_Lhs, _Rhs>& op) _NOEXCEPT {
+			const base_type result = op.template unwrap<base_type>();
+			value_ -= result;
+			return *this;
+		}
+
+		/// <summary> Equality operator. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> The other. </param>
+		/// <returns> True if the parameters are considered equivalent. </returns>
+		_CONSTEXPR_FN bool operator ==(const Vector<_T, _Size>& other) const _NOEXCEPT {
+			if (other.value_.isZero())
+				return value_.isMuchSmallerThan(other.value_, epsilon);
+			return value_.isApprox(other.value_);
+		}
+
+		/// <summary> Inequality operator. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> The other. </param>
+		/// <returns> True if the parameters are not considered equivalent. </returns>
+		_CONSTEXPR_FN bool operator !=(const Vector<_T, _Size>& other) const _NOEXCEPT {
+			return !(*this == other);
+		}
+
+	public:
+		/// <summary> Gets the size. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The size. </returns>
+		_CONSTEXPR_FN size_t GetSize() const _NOEXCEPT {
+			return static_cast<size_t>(value_.size());
+		}
+
+		/// <summary> Gets an element. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index. </param>
+		/// <returns> The element. </returns>
+		_CONSTEXPR_FN _T GetElement(const size_t index) const _NOEXCEPT {
+			return value_(index);
+		}
+
+		/// <summary> Sets an element. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index. </param>
+		/// <param name="value"> The value. </param>
+		_CONSTEXPR_FN void SetElement(const size_t index, const _T value) _NOEXCEPT {
+			value_(index) = value;
+		}
+
+		/// <summary> Element accessor. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="index"> Zero-based index. </param>
+		/// <returns> The element. </returns>
+		_T& operator()(const size_t index) _NOEXCEPT {
+			return value_(index);
+		}
+
+		/// <summary> Gets the contiguous values, valid until this is resized. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The values. </returns>
+		_T* Data() _NOEXCEPT {
+			return value_.data();
+		}
+
+		/// <summary> Gets the contiguous values, valid until this is resized. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The values. </returns>
+		const _T* Data() const _NOEXCEPT {
+			return value_.data();
+		}
+
+		/// <summary> Dot product. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="other"> Other Vector instance. </param>
+		/// <returns> The dot product. </returns>
+		_CONSTEXPR_FN _T Dot(const Vector<_T, _Size>& other) const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Dot");
+			return value_.dot(other.value_);
+		}
+
+		/// <summary> Euclidean norm. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <returns> The norm. </returns>
+		_CONSTEXPR_FN _T Norm() const _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Norm");
+			return value_.norm();
+		}
+
+		/// <summary> Axpy, adds <c>alpha * x</c> to this in place. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="alpha"> The scale. </param>
+		/// <param name="x">	 The vector to be added. </param>
+		/// <returns> This. </returns>
+		_CONSTEXPR_FN Vector<_T, _Size>& Axpy(const _T alpha, const Vector<_T, _Size>& x) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Axpy");
+			value_ += alpha * x.value_;
+			return *this;
+		}
+
+	public:
+		/// <summary>
+		/// 	<para> Destination-passing GEMV <c>out = alpha * op(matrix) * x + beta * out</c>. </para>
+		/// 	<para> Nothing is allocated when <c>out</c> already has the result size, and alpha is 1 or
+		/// 	beta is 0. </para>
+		/// </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">		 [in,out] The destination, MUST NOT be x. When beta is not zero it
+		/// 	MUST have the result size, otherwise it is resized. </param>
+		/// <param name="matrix">	 The matrix of any storage order. </param>
+		/// <param name="x">		 The vector. </param>
+		/// <param name="alpha">	 (Optional) Scale of the product. </param>
+		/// <param name="beta">		 (Optional) Scale of the original destination, 0 to ignore it. </param>
+		/// <param name="transpose"> (Optional) True to use the transpose of the matrix. </param>
+		template<int _Layout>
+		static void Multiply(Vector<_T, _Size>& out, const Matrix<_T, _Layout>& matrix, const Vector<_T, _Size>& x,
+							 const _T alpha = _T(1), const _T beta = _T(0), const bool transpose = false) {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Multiply");
+			if (beta == _T(0))
+				out.value_.resize(transpose ? matrix.GetNumColumns() : matrix.GetNumRows());
+			if (transpose)
+				MultiplyInto(out.value_, matrix.unwrap().transpose(), x.value_, alpha, beta);
+			else
+				MultiplyInto(out.value_, matrix.unwrap(), x.value_, alpha, beta);
+		}
+
+		/// <summary> GEMV <c>y = alpha * op(matrix) * x + beta * y</c> on arrays, without copying. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="y">		 [in,out] The destination, MUST NOT overlap x, the caller MUST ensure its size
+		/// 	is the rows of op(matrix). </param>
+		/// <param name="matrix">	 The matrix of any storage order. </param>
+		/// <param name="x">		 The vector, the caller MUST ensure its size is the columns of op(matrix). </param>
+		/// <param name="alpha">	 (Optional) Scale of the product. </param>
+		/// <param name="beta">		 (Optional) Scale of the original destination, 0 to ignore it. </param>
+		/// <param name="transpose"> (Optional) True to use the transpose of the matrix. </param>
+		template<int _Layout>
+		static void Multiply(_T y[], const Matrix<_T, _Layout>& matrix, const _T x[],
+							 const _T alpha = _T(1), const _T beta = _T(0), const bool transpose = false) {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Multiply");
+			const Eigen::Index rows = transpose ? matrix.GetNumColumns() : matrix.GetNumRows();
+			const Eigen::Index cols = transpose ? matrix.GetNumRows() : matrix.GetNumColumns();
+			Eigen::Map<base_type> y_map(y, rows);
+			if (transpose)
+				MultiplyInto(y_map, matrix.unwrap().transpose(), Eigen::Map<const base_type>(x, cols), alpha, beta);
+			else
+				MultiplyInto(y_map, matrix.unwrap(), Eigen::Map<const base_type>(x, cols), alpha, beta);
+		}
+
+		/// <summary> Dot product of arrays, without copying. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="x">    The first vector. </param>
+		/// <param name="y">    The second vector. </param>
+		/// <param name="size"> The size of both. </param>
+		/// <returns> The dot product. </returns>
+		static _T Dot(const _T x[], const _T y[], const size_t size) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Dot");
+			return Eigen::Map<const base_type>(x, size).dot(Eigen::Map<const base_type>(y, size));
+		}
+
+		/// <summary> Euclidean norm of an array, without copying. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="x">    The vector. </param>
+		/// <param name="size"> The size. </param>
+		/// <returns> The norm. </returns>
+		static _T Norm(const _T x[], const size_t size) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Norm");
+			return Eigen::Map<const base_type>(x, size).norm();
+		}
+
+		/// <summary> Axpy <c>y += alpha * x</c> on arrays, without copying. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="size">  The size of both. </param>
+		/// <param name="alpha"> The scale. </param>
+		/// <param name="x">	 The vector to be added. </param>
+		/// <param name="y">	 [in,out] The destination. </param>
+		static void Axpy(const size_t size, const _T alpha, const _T x[], _T y[]) _NOEXCEPT {
+			NUDTTK_INSTRUMENT_SCOPE("Vector::Axpy");
+			Eigen::Map<base_type>(y, size) += alpha * Eigen::Map<const base_type>(x, size);
+		}
+
+	private:
+		/// <summary> Evaluate <c>out = alpha * matrix * x + beta * out</c>. </summary>
+		/// <remarks> Blue Wing, 2026/10/19. </remarks>
+		/// <param name="out">	  The destination of the result size. </param>
+		/// <param name="matrix"> The matrix or its transpose. </param>
+		/// <param name="x">	  The vector. </param>
+		/// <param name="alpha">  The product scale. </param>
+		/// <param name="beta">   The destination scale. </param>
+		template<typename _Out, typename _Matrix, typename _Vector>
+		static void MultiplyInto(_Out& out, const _Matrix& matrix, const _Vector& x, const _T alpha, const _T beta) {
+			// Member call syntax, see Matrix::MultiplyInto
+			if (beta == _T(0)) {
+				out.noalias() = matrix.operator*(x);
+				if (alpha != _T(1))
+					out *= alpha;
+			} else {
+				if (beta != _T(1))
+					out *= beta;
+				if (alpha == _T(1))
+					out.noalias() += matrix.operator*(x);
+				else
+					out.noalias() += matrix.operator*(alpha).operator*(x);
+			}
+		}
+
+		// The vector value
+		base_type value_;
+	};
+}
+
+
+#endif	// #ifndef _NUDTTK_MATH_VECTOR_TR_
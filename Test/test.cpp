@@ -1,6 +1,24 @@
 #include "pch.h"
 
+// Track std containers and new[] in the instrumentation build
+#define NUDTTK_INSTRUMENT_GLOBAL_NEW
 #include "../Math/matrix.h"
+#include "../Math/vector.h"
+#include "../Math/diagonal_matrix.h"
+#include "../Math/block_diagonal_matrix.h"
+#include "../Math/normal_equation.h"
+#include "../Math/least_squares.h"
+#include "../Math/randomized_svd.h"
+#include "../Math/matrix_exponential.h"
+#include "../Math/covariance.h"
+#include "../Math/result_cache.h"
+#include "../Math/elementwise.h"
+#include "../Math/deferred.h"
+#include "../Math/statistics.h"
+#include "../Math/math_algorithm.h"
+
+#include <atomic>
+#include <thread>
 
 #pragma warning(disable: 4996)
 TEST(matrix_initialization, default_constructor) {
@@ -273,8 +291,8 @@ TEST(matrix_operator, combination_operations) {
 
 	EXPECT_EQ(mt.GetNumRows(), 2);
 	EXPECT_EQ(mt.GetNumColumns(), 2);
-	EXPECT_DOUBLE_EQ(mt.GetElement(0, 0), 8.0);
-	EXPECT_DOUBLE_EQ(mt.GetElement(1, 1), 13.0);
+	EXPECT_DOUBLE_EQ(mt.GetElement(0, 0), 14.0);
+	EXPECT_DOUBLE_EQ(mt.GetElement(1, 1), 19.0);
 }
 
 TEST(matrix_operator, compatibility_operations) {
@@ -296,6 +314,93 @@ TEST(matrix_operator, operator_rw_operations) {
 	EXPECT_DOUBLE_EQ(mt(1, 1), 1.0);
 }
 
+TEST(matrix_operator, compound_assignment) {
+	double value[] = { -2.0, 1.0, 4.0, -3.0 };
+	double value_b[] = { 1.0, 2.0, 3.0, 4.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+	NUDTTK::Matrix<double> mt_b(2, value_b);
+	NUDTTK::Matrix<double> mt_copy(mt);
+	EXPECT_DOUBLE_EQ(mt.DetGauss(), 2.0);
+
+	mt += mt_b;
+	EXPECT_DOUBLE_EQ(mt.GetElement(0, 0), -1.0);
+	EXPECT_DOUBLE_EQ(mt.DetGauss(), -1.0 * 1.0 - 3.0 * 7.0);
+	EXPECT_DOUBLE_EQ(mt_copy.GetElement(0, 0), -2.0);
+	mt -= mt_b;
+	mt *= 2.0;
+	mt /= 4.0;
+	EXPECT_DOUBLE_EQ(mt.GetElement(1, 0), 2.0);
+
+	// Products accumulate in place, also when an operand is this
+	NUDTTK::Matrix<double> mt_n(2);
+	mt_n += mt_b.Transpose() * mt_b;
+	EXPECT_DOUBLE_EQ(mt_n.GetElement(0, 0), 10.0);
+	EXPECT_DOUBLE_EQ(mt_n.GetElement(0, 1), 14.0);
+	mt_n -= mt_n * mt_b;
+	EXPECT_DOUBLE_EQ(mt_n.GetElement(0, 0), 10.0 - (10.0 * 1.0 + 14.0 * 3.0));
+	mt_b += mt_b + mt_b;
+	EXPECT_DOUBLE_EQ(mt_b.GetElement(1, 1), 12.0);
+	mt_b *= mt_b;
+	EXPECT_DOUBLE_EQ(mt_b.GetElement(0, 0), 3.0 * 3.0 + 6.0 * 9.0);
+}
+
+TEST(matrix_operator, rvalue_operations) {
+	double value_a[] = { 1.0, 2.0, 3.0, 4.0 };
+	double value_b[] = { 0.0, 1.0, -1.0, 2.0 };
+	NUDTTK::Matrix<double> mt_a(2, value_a);
+	NUDTTK::Matrix<double> mt_b(2, value_b);
+
+	// A temporary operand becomes the result
+	NUDTTK::Matrix<double> mt_t(mt_a);
+	mt_t.SetElement(0, 0, 1.0);
+	const double* data = mt_t.unwrap().data();
+	NUDTTK::Matrix<double> mt_r = std::move(mt_t) + mt_b - mt_a;
+	EXPECT_EQ(mt_r.unwrap().data(), data);
+	EXPECT_EQ(mt_r, mt_b);
+	mt_r = 2.0 * (std::move(mt_r) * 3.0) / 6.0;
+	EXPECT_EQ(mt_r.unwrap().data(), data);
+	EXPECT_EQ(mt_r, mt_b);
+
+	// Scalars are held by the expression, a chain of temporaries allocates as a single operation
+	NUDTTK::Instrumentation::Reset();
+	NUDTTK::Matrix<double> mt_c = mt_a + mt_b;
+	const size_t single = NUDTTK::Instrumentation::TakeSnapshot().Allocation("Matrix::add_op_impl").allocations;
+	NUDTTK::Instrumentation::Reset();
+	mt_c = (mt_a + mt_b) * 2.0 - mt_b / 0.5 + mt_a;
+	EXPECT_DOUBLE_EQ(mt_c.GetElement(1, 1), 2.0 * 6.0 - 4.0 + 4.0);
+	EXPECT_DOUBLE_EQ(mt_c.GetElement(1, 0), 2.0 * 2.0 + 2.0 + 3.0);
+	if (NUDTTK::Instrumentation::Enabled()) {
+		EXPECT_EQ(NUDTTK::Instrumentation::TakeSnapshot().Allocation("Matrix::add_op_impl").allocations, single);
+	}
+}
+TEST(matrix_operator, destination_passing_multiply) {
+	double value_a[] = { 1.0, 2.0, 3.0, 4.0 };
+	double value_b[] = { 0.0, 1.0, -1.0, 2.0 };
+	NUDTTK::Matrix<double> mt_a(2, value_a);
+	NUDTTK::Matrix<double> mt_b(2, value_b);
+	NUDTTK::Matrix<double> out;
+
+	NUDTTK::Multiply(out, mt_a, mt_b);
+	EXPECT_EQ(out, NUDTTK::Matrix<double>(mt_a * mt_b));
+	NUDTTK::Multiply(out, mt_a, mt_b, 2.0, 1.0, true, false);
+	EXPECT_EQ(out, NUDTTK::Matrix<double>(mt_a * mt_b + mt_a.Transpose() * mt_b + mt_a.Transpose() * mt_b));
+	NUDTTK::Multiply(out, mt_a, mt_b, 1.0, 0.0, false, true);
+	EXPECT_EQ(out, NUDTTK::Matrix<double>(mt_a * mt_b.Transpose()));
+
+	// Chain with two buffers, no allocation per step
+	NUDTTK::Matrix<double> phi, next(2, 2);
+	phi.MakeUnitMatrix(2);
+	NUDTTK::Instrumentation::Reset();
+	for (int i = 0; i < 3; i++) {
+		NUDTTK::Multiply(next, mt_b, phi);
+		std::swap(phi, next);
+	}
+	EXPECT_EQ(phi, NUDTTK::Matrix<double>(mt_b * mt_b * mt_b));
+	if (NUDTTK::Instrumentation::Enabled()) {
+		EXPECT_EQ(NUDTTK::Instrumentation::TakeSnapshot().Allocation("Matrix::Multiply").allocations, 0);
+	}
+}
+
 TEST(matrix_function, absolute) {
 	double value[] = { -2.0, 2.0, 2.0, -2.0 };
 	NUDTTK::Matrix<double> mt(2, value);
@@ -388,4 +493,918 @@ TEST(matrix_function, transpose) {
 	EXPECT_DOUBLE_EQ(mt_t.GetElement(0, 1), 4.0);
 	EXPECT_DOUBLE_EQ(mt.GetElement(1, 0), 4.0);
 	EXPECT_DOUBLE_EQ(mt_t.GetElement(1, 0), 1.0);
-}
\ No newline at end of file
+}
+
+TEST(matrix_function, copy_on_write) {
+	double value[] = { -2.0, 1.0, 4.0, -3.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+	NUDTTK::Matrix<double> mt_inv(mt.Inv());
+	NUDTTK::Matrix<double> mt_copy(mt);
+
+	// Mutation detaches the copy and drops its cached results only
+	mt_copy(0, 0) = 2.0;
+	EXPECT_DOUBLE_EQ(mt.GetElement(0, 0), -2.0);
+	EXPECT_DOUBLE_EQ(mt_copy.DetGauss(), -10.0);
+	EXPECT_DOUBLE_EQ(mt.DetGauss(), 2.0);
+
+	// Results share the cache, but modifying one must not alter the cache
+	mt_inv.SetElement(0, 0, 0.0);
+	EXPECT_DOUBLE_EQ(mt.Inv().GetElement(0, 0), -1.5);
+
+	// Assigning an expression drops cached results
+	mt = mt * mt;
+	EXPECT_DOUBLE_EQ(mt.DetGauss(), 4.0);
+	EXPECT_NEAR(mt.Inv().GetElement(0, 0), 3.25, 1e-12);
+}
+TEST(matrix_function, storage_layout) {
+	double value_a[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+	double value_b[] = { 0.0, 1.0, -1.0, 2.0, 3.0, -2.0 };
+	typedef NUDTTK::Matrix<double, Eigen::ColMajor> col_major;
+	NUDTTK::Matrix<double> mt_a(2, 3, value_a);
+	col_major mt_b(2, 3, value_b);
+
+	// Default values are given row by row in either order
+	EXPECT_DOUBLE_EQ(mt_b.GetElement(1, 0), 2.0);
+	EXPECT_EQ(mt_b.unwrap().data()[1], 2.0);
+
+	// Mixed expressions evaluate into the destination order
+	col_major mt_c = mt_a + mt_b * 2.0;
+	NUDTTK::Matrix<double> mt_d = mt_a * mt_b.Transpose() - mt_a * mt_a.Transpose();
+	EXPECT_DOUBLE_EQ(mt_c.GetElement(1, 2), 6.0 - 4.0);
+	EXPECT_DOUBLE_EQ(mt_d.GetElement(0, 1), (2.0 + 6.0 - 6.0) - (4.0 + 10.0 + 18.0));
+	EXPECT_EQ(NUDTTK::Matrix<double>(mt_c), mt_a + NUDTTK::Matrix<double>(mt_b) * 2.0);
+
+	// The transpose in the other order shares the storage layout of the original
+	col_major mt_t = mt_a.ReinterpretTranspose();
+	EXPECT_EQ(mt_t, col_major(mt_a.Transpose()));
+	EXPECT_TRUE(std::equal(mt_a.unwrap().data(), mt_a.unwrap().data() + 6, mt_t.unwrap().data()));
+	EXPECT_EQ(col_major(mt_t * mt_b), col_major(mt_a.Transpose() * NUDTTK::Matrix<double>(mt_b)));
+
+	NUDTTK::Matrix<double> out;
+	NUDTTK::Multiply(out, mt_t, mt_b, 1.0, 0.0, true, true);
+	EXPECT_EQ(out, mt_d + mt_a * mt_a.Transpose());
+}
+
+TEST(matrix_function, async_evaluation) {
+	double value[] = { 4.0, 1.0, 2.0, 3.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+
+	// The inverse of the task is cached for the matrix
+	std::future<NUDTTK::Matrix<double>> inverse = mt.InvAsync();
+	std::future<double> determinant = mt.DetGaussAsync();
+	std::future<NUDTTK::Matrix<double>> product = NUDTTK::Matrix<double>::MultiplyAsync(mt, mt, true, false);
+	NUDTTK::Matrix<double> result = inverse.get();
+	EXPECT_EQ(result.unwrap().data(), mt.Inv().unwrap().data());
+	EXPECT_DOUBLE_EQ(determinant.get(), 10.0);
+	EXPECT_EQ(product.get(), NUDTTK::Matrix<double>(mt.Transpose() * mt));
+
+	// A matrix modified meanwhile is detached from the task
+	inverse = mt.InvAsync();
+	mt.SetElement(0, 0, 2.0);
+	EXPECT_EQ(inverse.get(), result);
+	EXPECT_DOUBLE_EQ(mt.DetGaussAsync().get(), 4.0);
+}
+TEST(matrix_function, deferred_evaluation) {
+	double value_a[] = { 1.0, 2.0, 0.0, -1.0, 3.0, 1.0, 2.0, 0.0, 1.0 };
+	double value_b[] = { 2.0, 0.0, 1.0, 1.0, 1.0, 0.0, 0.0, -2.0, 3.0 };
+	double value_e[] = { 4.0, 1.0, 0.0, 1.0, 3.0, 1.0, 0.0, 1.0, 2.0 };
+	NUDTTK::Matrix<double> mt_a(3, value_a), mt_b(3, value_b), mt_e(3, value_e);
+	NUDTTK::Matrix<double> expected = mt_a * mt_b + mt_b * mt_a - mt_e.Inv();
+
+	// Two products and an inverse run concurrently
+	NUDTTK::Matrix<double> result;
+	EXPECT_EQ(NUDTTK::EvaluateDeferred(result, mt_a * mt_b + mt_b * mt_a - NUDTTK::Inverse(mt_e)), 3);
+	EXPECT_EQ(result, expected);
+
+	// Identical subexpressions are evaluated once, also on copies sharing the storage
+	NUDTTK::Matrix<double> copy = mt_a;
+	EXPECT_EQ(NUDTTK::EvaluateDeferred(result, (mt_a * mt_b) * mt_e + (copy * mt_b) * 2.0), 2);
+	EXPECT_EQ(result, NUDTTK::Matrix<double>(mt_a * mt_b * mt_e + mt_a * mt_b * 2.0));
+
+	// The destination may be an operand, an inverse node is also evaluated eagerly
+	expected = mt_a * mt_b;
+	NUDTTK::EvaluateDeferred(mt_a, mt_a * mt_b);
+	EXPECT_EQ(mt_a, expected);
+	EXPECT_EQ(NUDTTK::Matrix<double>(mt_b + NUDTTK::Inverse(mt_e)), NUDTTK::Matrix<double>(mt_b + mt_e.Inv()));
+}
+namespace scalar_functions {
+	inline double Abs(const double x) {
+		return std::fabs(x);
+	}
+}
+TEST(matrix_function, elementwise_functions) {
+	double value_a[] = { 1.0, 4.0, 9.0, 16.0 };
+	double value_b[] = { 2.0, -1.0, 0.5, 4.0 };
+	NUDTTK::Matrix<double> mt_a(2, value_a), mt_b(2, value_b);
+
+	// Element-wise functions and coefficient-wise products in an expression chain
+	NUDTTK::Matrix<double> mt = NUDTTK::Sqrt(mt_a) * 2.0 + NUDTTK::CwiseProduct(mt_a, mt_b) - mt_b;
+	EXPECT_DOUBLE_EQ(mt.GetElement(0, 1), 4.0 - 4.0 + 1.0);
+	EXPECT_DOUBLE_EQ(mt.GetElement(1, 1), 8.0 + 64.0 - 4.0);
+	mt = NUDTTK::CwiseQuotient(mt_a + mt_a, NUDTTK::Square(mt_b));
+	EXPECT_DOUBLE_EQ(mt.GetElement(1, 0), 18.0 / 0.25);
+	mt = NUDTTK::Exp(NUDTTK::Log(mt_a)) - NUDTTK::Pow(NUDTTK::Abs(mt_a * -1.0), 1.5);
+	EXPECT_NEAR(mt.GetElement(1, 0), 9.0 - 27.0, 1e-12);
+	mt = NUDTTK::Square(NUDTTK::Sin(mt_b)) + NUDTTK::Square(NUDTTK::Cos(mt_b));
+	EXPECT_NEAR(mt.GetElement(0, 1), 1.0, 1e-15);
+	EXPECT_DOUBLE_EQ(NUDTTK::Matrix<double>(NUDTTK::Tan(mt_b)).GetElement(1, 1), std::tan(4.0));
+
+	// Products of element-wise nodes, also on vectors and deferred
+	NUDTTK::Vector<double> vt(2, value_b);
+	NUDTTK::Vector<double> vt_r = NUDTTK::Sqrt(mt_a) * NUDTTK::CwiseProduct(vt, vt);
+	EXPECT_DOUBLE_EQ(vt_r.GetElement(1), 3.0 * 4.0 + 4.0 * 1.0);
+	NUDTTK::Matrix<double> result;
+	EXPECT_EQ(NUDTTK::EvaluateDeferred(result, NUDTTK::Sqrt(mt_a * mt_b) + NUDTTK::CwiseQuotient(mt_b, mt_a * mt_b)), 1);
+	EXPECT_EQ(result, NUDTTK::Matrix<double>(NUDTTK::Sqrt(mt_a * mt_b) + NUDTTK::CwiseQuotient(mt_b, mt_a * mt_b)));
+
+	// A scalar is no operand, the scalar overload is found even if the element-wise one is visible
+	using namespace NUDTTK;
+	using namespace scalar_functions;
+	EXPECT_DOUBLE_EQ(Abs(-2), 2.0);
+}
+TEST(matrix_function, decompositions) {
+	double value_p[] = { 4.0, 1.0, 0.0, 1.0, 3.0, 1.0, 0.0, 1.0, 2.0 };
+	NUDTTK::Matrix<double> mt_p(3, value_p);
+
+	// Symmetric eigendecomposition and its largest part
+	NUDTTK::Vector<double> values;
+	NUDTTK::Matrix<double> vectors;
+	ASSERT_TRUE(mt_p.Eigen(values, vectors));
+	EXPECT_NEAR(values.GetElement(0), 3.0 - std::sqrt(3.0), 1e-12);
+	EXPECT_NEAR(values.GetElement(2), 3.0 + std::sqrt(3.0), 1e-12);
+	EXPECT_TRUE((mt_p.unwrap() * vectors.unwrap()).isApprox(vectors.unwrap() * values.unwrap().asDiagonal()));
+	ASSERT_TRUE(mt_p.Eigen(2, values, vectors));
+	EXPECT_EQ(values.GetSize(), 2);
+	EXPECT_NEAR(values.GetElement(0), 3.0 + std::sqrt(3.0), 1e-12);
+	EXPECT_NEAR(values.GetElement(1), 3.0, 1e-12);
+	EXPECT_EQ(vectors.GetNumColumns(), 2);
+	EXPECT_FALSE(mt_p.Eigen(4, values, vectors));
+	EXPECT_FALSE(NUDTTK::Matrix<double>(2, 3).Eigen(values, vectors));
+
+	// Thin SVD of small (Jacobi) and large (divide and conquer) matrices
+	const NUDTTK::Matrix<double>::base_type random = NUDTTK::Matrix<double>::base_type::Random(40, 30);
+	NUDTTK::Matrix<double> mt_small(3, 2, value_p), mt_large(random), u, v;
+	for (const NUDTTK::Matrix<double>* mt : { &mt_small, &mt_large }) {
+		ASSERT_TRUE(mt->Svd(values, u, v));
+		EXPECT_EQ(u.GetNumColumns(), mt->GetNumColumns());
+		EXPECT_TRUE((u.unwrap() * values.unwrap().asDiagonal() * v.unwrap().transpose()).isApprox(mt->unwrap()));
+		EXPECT_DOUBLE_EQ(mt->ConditionNumber(), values.GetElement(0) / values.GetElement(values.GetSize() - 1));
+		EXPECT_EQ(mt->Rank(), mt->GetNumColumns());
+	}
+	ASSERT_TRUE(mt_large.Svd(3, values, u, v));
+	EXPECT_EQ(u.GetNumColumns(), 3);
+	NUDTTK::Vector<double> singular_values;
+	ASSERT_TRUE(mt_large.Svd(singular_values));
+	EXPECT_DOUBLE_EQ(singular_values.GetElement(2), values.GetElement(2));
+
+	// Rank deficiency, the cached results are dropped when the matrix is modified
+	mt_p.SetElement(2, 2, 1.0 / 3.0);
+	mt_p.SetElement(0, 2, 1.0 / 3.0);
+	mt_p.SetElement(2, 0, 1.0 / 3.0);
+	EXPECT_GT(mt_p.ConditionNumber(), 1e12);
+	EXPECT_EQ(mt_p.Rank(), 2);
+	EXPECT_EQ(mt_p.Rank(0.99), 1);
+}
+TEST(matrix_function, structure_routing) {
+	typedef NUDTTK::Matrix<double>::base_type base_type;
+	const base_type random = base_type::Random(40, 40);
+	const base_type rhs = base_type::Random(40, 3);
+	base_type value_d = base_type::Zero(40, 40), value_b = base_type::Zero(40, 40);
+	value_d.diagonal() = random.diagonal().cwiseAbs().array() + 1.0;
+	for (Eigen::Index i = 0; i < 40; i++) {
+		for (Eigen::Index j = std::max<Eigen::Index>(0, i - 2); j <= std::min<Eigen::Index>(39, i + 2); j++)
+			value_b(i, j) = i == j ? 8.0 : 1.0 / (1.0 + i + j);
+	}
+	const base_type value_l = value_d + base_type(random.triangularView<Eigen::StrictlyLower>());
+	const base_type value_u = value_l.transpose();
+	const base_type value_p = random * random.transpose() + base_type::Identity(40, 40);
+
+	// Detected structures and their solvers against the general LU
+	struct { const base_type* value; int flags; } cases[] = {
+		{ &value_d, NUDTTK::Structure::Diagonal | NUDTTK::Structure::Symmetric },
+		{ &value_l, NUDTTK::Structure::Lower }, { &value_u, NUDTTK::Structure::Upper },
+		{ &value_p, NUDTTK::Structure::Symmetric },
+		{ &value_b, NUDTTK::Structure::Symmetric | NUDTTK::Structure::Banded },
+		{ &random, NUDTTK::Structure::General } };
+	for (const auto& item : cases) {
+		const NUDTTK::Matrix<double> mt(*item.value);
+		EXPECT_EQ(mt.AnalyzeStructure(), item.flags);
+		const Eigen::FullPivLU<base_type> lu(*item.value);
+		EXPECT_NEAR(mt.DetGauss(), lu.determinant(), 1e-10 * std::fabs(lu.determinant()));
+		EXPECT_TRUE(mt.Inv().unwrap().isApprox(base_type(lu.inverse()), 1e-10));
+		const NUDTTK::Matrix<double> mt_x = mt.Solve(NUDTTK::Matrix<double>(rhs));
+		EXPECT_TRUE(mt_x.unwrap().isApprox(base_type(lu.solve(rhs)), 1e-10));
+		const NUDTTK::Vector<double> vec_x = mt.Solve(NUDTTK::Vector<double>(NUDTTK::Vector<double>::base_type(rhs.col(0))));
+		EXPECT_TRUE(vec_x.unwrap().isApprox(mt_x.unwrap().col(0), 1e-12));
+	}
+
+	// An assumed structure reads only its triangle, a modified matrix is analyzed again
+	base_type value_pl = value_p;
+	value_pl.triangularView<Eigen::StrictlyUpper>().setConstant(1e30);
+	NUDTTK::Matrix<double> mt_pl(value_pl);
+	mt_pl.AssumeStructure(NUDTTK::Structure::PositiveDefinite);
+	EXPECT_TRUE(mt_pl.Inv().unwrap().isApprox(base_type(value_p.inverse()), 1e-10));
+	EXPECT_NEAR(mt_pl.DetGauss(), value_p.determinant(), 1e-10 * std::fabs(value_p.determinant()));
+	mt_pl.SetElement(0, 39, 0.0);
+	EXPECT_EQ(mt_pl.AnalyzeStructure(), NUDTTK::Structure::General);
+
+	// Re-assuming the structure drops the results routed by the previous one, e.g. a band factor
+	base_type value_t = base_type::Zero(16, 16);
+	for (Eigen::Index i = 0; i < 16; i++) {
+		value_t(i, i) = 4.0;
+		if (i > 0)
+			value_t(i, i - 1) = value_t(i - 1, i) = -1.0;
+	}
+	const base_type rhs_t = rhs.topRows(16);
+	const base_type x_t = value_t.fullPivLu().solve(rhs_t);
+	const int assumed[] = { NUDTTK::Structure::PositiveDefinite | NUDTTK::Structure::Banded, NUDTTK::Structure::PositiveDefinite,
+							NUDTTK::Structure::PositiveDefinite | NUDTTK::Structure::Banded, NUDTTK::Structure::General };
+	NUDTTK::Matrix<double> mt_t(value_t);
+	for (const int flags : assumed) {
+		mt_t.AssumeStructure(flags, (flags & NUDTTK::Structure::Banded) ? 1 : 0);
+		EXPECT_TRUE(mt_t.Solve(NUDTTK::Matrix<double>(rhs_t)).unwrap().isApprox(x_t, 1e-10));
+		EXPECT_TRUE(mt_t.Inv().unwrap().isApprox(base_type(value_t.inverse()), 1e-10));
+		EXPECT_NEAR(mt_t.DetGauss(), value_t.determinant(), 1e-10 * std::fabs(value_t.determinant()));
+	}
+
+	// Symmetric but indefinite falls back to LU, singular and non-square are empty
+	double value_s[] = { 1.0, 2.0, 2.0, 1.0 };
+	NUDTTK::Matrix<double> mt_s(2, value_s);
+	EXPECT_EQ(mt_s.AnalyzeStructure(), NUDTTK::Structure::Symmetric);
+	EXPECT_DOUBLE_EQ(mt_s.DetGauss(), -3.0);
+	EXPECT_DOUBLE_EQ(mt_s.Inv().GetElement(0, 1), 2.0 / 3.0);
+	mt_s.SetElement(1, 1, 0.0);
+	mt_s.SetElement(0, 0, 0.0);
+	mt_s.SetElement(0, 1, 0.0);
+	EXPECT_EQ(mt_s.AnalyzeStructure(), NUDTTK::Structure::Lower);
+	EXPECT_EQ(mt_s.Inv().GetNumRows(), 0);
+	EXPECT_EQ(NUDTTK::Matrix<double>(2, 3).Solve(NUDTTK::Matrix<double>(2, 1)).GetNumRows(), 0);
+	EXPECT_EQ(mt_s.Solve(NUDTTK::Matrix<double>(3, 1)).GetNumRows(), 0);
+}
+TEST(matrix_function, statistics) {
+	double value[] = { 3.0, -1.0, 4.0, 1.0, -5.0, 9.0, 2.0, 6.0, 5.0, 3.0, -5.0, 8.0 };
+	NUDTTK::Matrix<double> mt(3, 4, value);
+	NUDTTK::Matrix<double, Eigen::ColMajor> mt_col(mt);
+
+	// Requested statistics of all values, the first extreme is located
+	NUDTTK::Statistics<double> stat = NUDTTK::Reduce(mt_col, NUDTTK::Stat::Min | NUDTTK::Stat::Max | NUDTTK::Stat::Mean);
+	EXPECT_EQ(stat.count, 12);
+	EXPECT_DOUBLE_EQ(stat.minimum, -5.0);
+	EXPECT_EQ(stat.min_row, 1);
+	EXPECT_EQ(stat.min_col, 0);
+	EXPECT_DOUBLE_EQ(stat.maximum, 9.0);
+	EXPECT_EQ(stat.max_row, 1);
+	EXPECT_EQ(stat.max_col, 1);
+	EXPECT_DOUBLE_EQ(stat.mean, 30.0 / 12.0);
+	EXPECT_DOUBLE_EQ(stat.norm1, 0.0);
+
+	// Rows and columns in both storage orders
+	for (int layout = 0; layout < 2; layout++) {
+		std::vector<NUDTTK::Statistics<double>> rows = layout ? NUDTTK::ReduceRows(mt_col) : NUDTTK::ReduceRows(mt);
+		std::vector<NUDTTK::Statistics<double>> cols = layout ? NUDTTK::ReduceColumns(mt_col) : NUDTTK::ReduceColumns(mt);
+		ASSERT_EQ(rows.size(), 3);
+		ASSERT_EQ(cols.size(), 4);
+		EXPECT_DOUBLE_EQ(rows[2].sum, 11.0);
+		EXPECT_DOUBLE_EQ(rows[2].norm1, 21.0);
+		EXPECT_EQ(rows[2].min_col, 2);
+		EXPECT_DOUBLE_EQ(rows[0].variance, 14.75 / 3.0);
+		EXPECT_DOUBLE_EQ(cols[1].norm2, std::sqrt(1.0 + 81.0 + 9.0));
+		EXPECT_DOUBLE_EQ(cols[2].norm_inf, 5.0);
+		EXPECT_EQ(cols[2].min_row, 2);
+		EXPECT_EQ(cols[3].max_row, 2);
+		EXPECT_DOUBLE_EQ(cols[0].variance, 28.0);
+	}
+
+	// NaN values are counted, a large matrix is reduced in parallel
+	value[5] = std::numeric_limits<double>::quiet_NaN();
+	EXPECT_EQ(NUDTTK::Reduce(value, 12).nan_count, 1);
+	const NUDTTK::Matrix<double>::base_type random = NUDTTK::Matrix<double>::base_type::Random(400, 300);
+	NUDTTK::Matrix<double> mt_large(random);
+	stat = NUDTTK::Reduce(mt_large);
+	EXPECT_NEAR(stat.sum, mt_large.unwrap().sum(), 1e-9);
+	EXPECT_DOUBLE_EQ(stat.maximum, mt_large.Max());
+	const double mean = mt_large.unwrap().mean();
+	EXPECT_NEAR(stat.variance, (mt_large.unwrap().array() - mean).square().sum() / (400 * 300 - 1), 1e-12);
+	EXPECT_DOUBLE_EQ(NUDTTK::ReduceColumns(mt_large)[7].minimum, mt_large.unwrap().col(7).minCoeff());
+
+	// Empty inputs have no extremes
+	stat = NUDTTK::Reduce(NUDTTK::Matrix<double>());
+	EXPECT_EQ(stat.count, 0);
+	EXPECT_TRUE(std::isnan(stat.minimum));
+	EXPECT_TRUE(std::isnan(stat.maximum));
+	EXPECT_TRUE(std::isnan(stat.mean));
+	EXPECT_EQ(stat.min_row, 0);
+	EXPECT_DOUBLE_EQ(stat.sum, 0.0);
+	EXPECT_EQ(NUDTTK::Reduce(value, 0).count, 0);
+	const std::vector<NUDTTK::Statistics<double>> empty_cols = NUDTTK::ReduceColumns(NUDTTK::Matrix<double>(0, 3));
+	ASSERT_EQ(empty_cols.size(), 3);
+	EXPECT_TRUE(std::isnan(empty_cols[2].maximum));
+	EXPECT_EQ(NUDTTK::ReduceRows(NUDTTK::Matrix<double, Eigen::ColMajor>(Eigen::MatrixXd(2, 0)))[1].count, 0);
+
+	// RobustStatMean starts from the sample variance, a single value has none
+	double x[] = { 1.0, 2.0, 6.0 }, w[3], dMean, dVar;
+	EXPECT_TRUE(NUDTTK::Math::RobustStatMean(x, w, 3, dMean, dVar));
+	EXPECT_DOUBLE_EQ(dMean, 3.0);
+	EXPECT_DOUBLE_EQ(dVar, std::sqrt(7.0));
+	EXPECT_TRUE(NUDTTK::Math::RobustStatMean(x, w, 1, dMean, dVar));
+	EXPECT_DOUBLE_EQ(dMean, 1.0);
+	EXPECT_TRUE(std::isnan(dVar));
+	EXPECT_EQ(w[0], 0.0);
+}
+TEST(vector_operator, expression_and_kernels) {
+	double value_m[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+	double value_x[] = { 1.0, -1.0, 2.0 };
+	double value_y[] = { 0.5, 2.0 };
+	NUDTTK::Matrix<double> mt(2, 3, value_m);
+	NUDTTK::Vector<double> vt_x(3, value_x);
+	NUDTTK::Vector<double> vt_y(2, value_y);
+
+	// Matrix-vector products in expressions
+	NUDTTK::Vector<double> vt = mt * vt_x * 2.0 - vt_y + vt_y / 0.5;
+	EXPECT_EQ(vt.GetSize(), 2);
+	EXPECT_DOUBLE_EQ(vt.GetElement(0), 2.0 * 5.0 + 0.5);
+	EXPECT_DOUBLE_EQ(vt.GetElement(1), 2.0 * 11.0 + 2.0);
+	NUDTTK::Vector<double, 2> vt_fixed = mt.Transpose().Transpose() * vt_x;
+	EXPECT_DOUBLE_EQ(vt_fixed.GetElement(1), 11.0);
+
+	// Kernels on vectors and on arrays without copying
+	EXPECT_DOUBLE_EQ(vt_x.Dot(vt_x), 6.0);
+	EXPECT_DOUBLE_EQ(NUDTTK::Vector<double>::Norm(value_x, 3), std::sqrt(6.0));
+	vt_y.Axpy(2.0, vt_y);
+	EXPECT_DOUBLE_EQ(vt_y.GetElement(1), 6.0);
+	double value_z[] = { 1.0, 1.0, 1.0 };
+	NUDTTK::Vector<double>::Multiply(value_z, mt, value_y, 1.0, 2.0, true);
+	EXPECT_DOUBLE_EQ(value_z[2], 2.0 + 3.0 * 0.5 + 6.0 * 2.0);
+	NUDTTK::Vector<double>::Axpy(3, -1.0, value_z, value_z);
+	EXPECT_DOUBLE_EQ(NUDTTK::Vector<double>::Dot(value_z, value_x, 3), 0.0);
+
+	NUDTTK::Vector<double> out(2);
+	NUDTTK::Vector<double>::Multiply(out, mt, vt_x);
+	EXPECT_EQ(out, NUDTTK::Vector<double>(mt * vt_x));
+
+	// A matrix expression keeps its shape in a vector result
+	NUDTTK::Vector<double> vt_sum = (mt + mt) * vt_x;
+	EXPECT_DOUBLE_EQ(vt_sum.GetElement(1), 22.0);
+}
+TEST(diagonal_matrix, weighted_products) {
+	double value_c[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0 };
+	double value_w[] = { 2.0, 0.0, 1.0, 0.5 };
+	double value_y[] = { 1.0, -1.0, 2.0, 4.0 };
+	NUDTTK::Matrix<double> mt_c(4, 2, value_c);
+	NUDTTK::DiagonalMatrix<double> mt_w(4, value_w);
+	NUDTTK::Vector<double> vt_y(4, value_y);
+	NUDTTK::Matrix<double> mt_dense(4, 4);
+	for (size_t i = 0; i < 4; i++)
+		mt_dense.SetElement(i, i, value_w[i]);
+	NUDTTK::Matrix<double> expected = mt_c.Transpose() * mt_dense * mt_c;
+
+	// C^T W C as an expression and into a preallocated destination
+	NUDTTK::Matrix<double> mt_n = mt_c.Transpose() * mt_w * mt_c;
+	EXPECT_EQ(mt_n, expected);
+	NUDTTK::Matrix<double, Eigen::ColMajor> mt_out(2, 2);
+	NUDTTK::Multiply(mt_out, mt_c, mt_w, mt_c, 2.0, 0.0, true, false);
+	EXPECT_DOUBLE_EQ(mt_out.GetElement(0, 1), 2.0 * expected.GetElement(0, 1));
+	NUDTTK::Multiply(mt_out, mt_c, mt_w, mt_c, 1.0, -2.0, true, false);
+	EXPECT_DOUBLE_EQ(mt_out.GetElement(1, 1), -3.0 * expected.GetElement(1, 1));
+
+	// Scaling rows and columns, C^T W y
+	NUDTTK::Vector<double> vt_wy = mt_w * vt_y;
+	EXPECT_DOUBLE_EQ(vt_wy.GetElement(3), 2.0);
+	NUDTTK::Matrix<double> mt_cw = mt_c.Transpose() * mt_w;
+	EXPECT_DOUBLE_EQ(mt_cw.GetElement(1, 0), 4.0);
+	NUDTTK::Matrix<double> mt_wc = mt_w * mt_c * 2.0;
+	EXPECT_DOUBLE_EQ(mt_wc.GetElement(3, 1), 8.0);
+	NUDTTK::Vector<double> vt_rhs = mt_c.Transpose() * mt_w * vt_y;
+	EXPECT_DOUBLE_EQ(vt_rhs.GetElement(0), 2.0 * 1.0 + 5.0 * 2.0 + 7.0 * 2.0);
+	EXPECT_DOUBLE_EQ(vt_rhs.GetElement(1), 2.0 * 2.0 + 6.0 * 2.0 + 8.0 * 2.0);
+}
+TEST(block_diagonal_matrix, structured_solve) {
+	// Blocks of 2, 3 and 1 parameters bordered by 2 global parameters, diagonally dominant
+	NUDTTK::BlockDiagonalMatrix<double> mt(std::vector<size_t>{ 2, 3, 1 }, 2);
+	EXPECT_EQ(mt.GetNumRows(), 8);
+	for (size_t i = 0; i < 8; i++) {
+		for (size_t j = 0; j < 8; j++)
+			mt.SetElement(i, j, i == j ? 10.0 + i : 1.0 / (1.0 + i + 2.0 * j));
+	}
+	EXPECT_FALSE(mt.SetElement(0, 2, 1.0));
+	EXPECT_DOUBLE_EQ(mt.GetElement(0, 2), 0.0);
+	EXPECT_DOUBLE_EQ(mt.GetElement(6, 3), 1.0 / 13.0);
+	EXPECT_DOUBLE_EQ(mt.GetBlock(1).GetElement(1, 0), 1.0 / 8.0);
+	NUDTTK::Matrix<double> dense = mt.ToMatrix();
+
+	double value_b[] = { 1.0, -2.0, 3.0, 0.5, -1.0, 2.0, 4.0, -3.0 };
+	NUDTTK::Vector<double> vt_b(8, value_b);
+	NUDTTK::Vector<double> vt_x = mt.Solve(vt_b);
+	EXPECT_EQ(NUDTTK::Vector<double>(mt * vt_x), vt_b);
+	EXPECT_EQ(vt_x, NUDTTK::Vector<double>(dense.Inv() * vt_b));
+	EXPECT_EQ(mt.Inv(), dense.Inv());
+	EXPECT_NEAR(mt.DetGauss(), dense.DetGauss(), 1e-9 * std::fabs(dense.DetGauss()));
+	EXPECT_EQ(mt * dense, NUDTTK::Matrix<double>(dense * dense));
+
+	// A copy shares the factorization until modified, a singular block bordered into an invertible
+	// matrix is solved dense
+	NUDTTK::BlockDiagonalMatrix<double> bordered = mt;
+	bordered.SetBlock(2, NUDTTK::Matrix<double>(1));
+	NUDTTK::Matrix<double> dense_bordered = bordered.ToMatrix();
+	const NUDTTK::Vector<double> vt_y = bordered.Solve(vt_b);
+	ASSERT_EQ(vt_y.GetSize(), 8);
+	EXPECT_TRUE(vt_y.unwrap().isApprox(dense_bordered.unwrap().fullPivLu().solve(vt_b.unwrap())));
+	EXPECT_NEAR(bordered.DetGauss(), dense_bordered.DetGauss(), 1e-9 * std::fabs(dense_bordered.DetGauss()));
+	EXPECT_TRUE(bordered.Inv().unwrap().isApprox(dense_bordered.unwrap().inverse()));
+	EXPECT_EQ(mt.Solve(vt_b), vt_x);
+
+	// Singular as a whole, the block and its border columns are zero
+	NUDTTK::BlockDiagonalMatrix<double> singular = bordered;
+	singular.SetBorderColumns(2, NUDTTK::Matrix<double>(1, 2));
+	EXPECT_EQ(singular.Solve(vt_b).GetSize(), 0);
+	EXPECT_EQ(singular.Inv().GetNumRows(), 0);
+	EXPECT_DOUBLE_EQ(singular.DetGauss(), 0.0);
+}
+TEST(normal_equation, schur_elimination) {
+	// Arcs with 2, 3 and 1 local parameters share 2 global parameters, the full system has 8
+	const size_t local_sizes[] = { 2, 3, 1 };
+	NUDTTK::Matrix<double> full(8, 8);
+	NUDTTK::Vector<double> full_rhs(8);
+	std::vector<NUDTTK::NormalEquation<double>> arcs;
+	for (size_t k = 0, offset = 0; k < 3; offset += local_sizes[k], k++) {
+		// A positive definite N = A^T A + I with observations l
+		const size_t size = local_sizes[k] + 2;
+		NUDTTK::Matrix<double> mt_a(size + 3, size);
+		NUDTTK::Vector<double> vt_l(size + 3);
+		for (size_t i = 0; i < size + 3; i++) {
+			vt_l(i) = std::cos(1.0 + i + k);
+			for (size_t j = 0; j < size; j++)
+				mt_a(i, j) = std::sin(1.0 + i * size + j + 7.0 * k);
+		}
+		NUDTTK::Matrix<double> mt_n = mt_a.Transpose() * mt_a;
+		for (size_t i = 0; i < size; i++)
+			mt_n(i, i) += 1.0;
+		NUDTTK::Vector<double> vt_b = mt_a.Transpose() * vt_l;
+		arcs.push_back(NUDTTK::NormalEquation<double>(mt_n, vt_b));
+
+		// Parameter i of the arc is parameter map[i] of the full system
+		std::vector<size_t> map;
+		for (size_t i = 0; i < local_sizes[k]; i++)
+			map.push_back(offset + i);
+		map.push_back(6);
+		map.push_back(7);
+		for (size_t i = 0; i < size; i++) {
+			full_rhs(map[i]) += vt_b(i);
+			for (size_t j = 0; j < size; j++)
+				full(map[i], map[j]) += mt_n.GetElement(i, j);
+		}
+	}
+	NUDTTK::Vector<double> expected = full.Inv() * full_rhs;
+
+	NUDTTK::SchurElimination<double> elimination;
+	ASSERT_TRUE(elimination.Eliminate(arcs, std::vector<size_t>(local_sizes, local_sizes + 3)));
+	EXPECT_EQ(elimination.GetReduced().GetNumParameters(), 2);
+	NUDTTK::Vector<double> global = elimination.GetReduced().Solve();
+	EXPECT_NEAR(global.GetElement(0), expected.GetElement(6), 1e-10);
+	EXPECT_NEAR(global.GetElement(1), expected.GetElement(7), 1e-10);
+	std::vector<NUDTTK::Vector<double>> locals;
+	ASSERT_TRUE(elimination.BackSubstitute(global, locals));
+	EXPECT_NEAR(locals[1].GetElement(2), expected.GetElement(4), 1e-10);
+	EXPECT_NEAR(elimination.BackSubstitute(2, global).GetElement(0), expected.GetElement(5), 1e-10);
+
+	// Arcs have to share the global parameters
+	EXPECT_FALSE(elimination.Eliminate(arcs, std::vector<size_t>{ 2, 2, 1 }));
+	EXPECT_FALSE(elimination.BackSubstitute(global, locals));
+}
+TEST(normal_equation, stacking) {
+	// Two normal equations of 3 and 4 parameters mapped onto 6 parameters
+	std::vector<NUDTTK::NormalEquation<double>> equations;
+	std::vector<std::vector<size_t>> index_maps{ { 0, 1, 4 }, { 3, 4, 5, 1 } };
+	NUDTTK::Matrix<double> expected(6, 6);
+	NUDTTK::Vector<double> expected_rhs(6);
+	for (size_t k = 0; k < 2; k++) {
+		const size_t size = index_maps[k].size();
+		NUDTTK::Matrix<double> mt_n(size, size);
+		NUDTTK::Vector<double> vt_b(size);
+		for (size_t i = 0; i < size; i++) {
+			vt_b(i) = 1.0 + i + 10.0 * k;
+			for (size_t j = 0; j < size; j++)
+				mt_n(i, j) = 1.0 + i * j + k;
+		}
+		equations.push_back(NUDTTK::NormalEquation<double>(mt_n, vt_b));
+		for (size_t i = 0; i < size; i++) {
+			expected_rhs(index_maps[k][i]) += vt_b.GetElement(i);
+			for (size_t j = 0; j < size; j++)
+				expected(index_maps[k][i], index_maps[k][j]) += mt_n.GetElement(i, j);
+		}
+	}
+
+	NUDTTK::NormalEquation<double> stacked;
+	ASSERT_TRUE(NUDTTK::NormalEquation<double>::Stack(equations, index_maps, 6, stacked));
+	EXPECT_EQ(stacked.GetNormalMatrix(), expected);
+	EXPECT_EQ(stacked.GetRightHandSide(), expected_rhs);
+
+	// Added one by one, also onto itself
+	NUDTTK::NormalEquation<double> added(6);
+	EXPECT_TRUE(added.Add(equations[0], index_maps[0]));
+	EXPECT_TRUE(added.Add(equations[1], index_maps[1]));
+	EXPECT_EQ(added.GetNormalMatrix(), expected);
+	EXPECT_TRUE(added.Add(added, std::vector<size_t>{ 0, 1, 2, 3, 4, 5 }));
+	EXPECT_EQ(added.GetRightHandSide(), NUDTTK::Vector<double>(expected_rhs * 2.0));
+
+	// Index maps have to fit
+	EXPECT_FALSE(added.Add(equations[0], std::vector<size_t>{ 0, 6, 1 }));
+	EXPECT_FALSE(NUDTTK::NormalEquation<double>::Stack(equations, index_maps, 5, stacked));
+}
+TEST(least_squares, factorizations) {
+	// A polynomial of order 10, the condition number of the design matrix is about 1e12, squared
+	// by the normal matrix
+	double value_a[30 * 10], value_b[30 * 2];
+	for (size_t i = 0; i < 30; i++) {
+		const double x = 0.5 * i;
+		for (size_t j = 0; j < 10; j++)
+			value_a[i * 10 + j] = std::pow(x, static_cast<double>(j));
+		value_b[i * 2] = value_b[i * 2 + 1] = 0.0;
+		for (size_t j = 0; j < 10; j++) {
+			value_b[i * 2] += value_a[i * 10 + j];
+			value_b[i * 2 + 1] += value_a[i * 10 + j] * (j % 2 ? -1.0 : 1.0);
+		}
+	}
+	NUDTTK::Matrix<double> mt_a(30, 10, value_a), mt_b(30, 2, value_b);
+
+	// Multiple right-hand sides with every factorization
+	const NUDTTK::LeastSquares<>::Method methods[] = {
+		NUDTTK::LeastSquares<>::QR, NUDTTK::LeastSquares<>::ColPivQR, NUDTTK::LeastSquares<>::COD };
+	for (const NUDTTK::LeastSquares<>::Method method : methods) {
+		const NUDTTK::LeastSquares<> solver(mt_a, method);
+		EXPECT_EQ(solver.GetRank(), 10);
+		const NUDTTK::Matrix<double> mt_x = solver.Solve(mt_b);
+		ASSERT_EQ(mt_x.GetNumRows(), 10);
+		for (size_t j = 0; j < 10; j++) {
+			EXPECT_NEAR(mt_x.GetElement(j, 0), 1.0, 1e-3);
+			EXPECT_NEAR(mt_x.GetElement(j, 1), j % 2 ? -1.0 : 1.0, 1e-3);
+		}
+	}
+
+	// Vectors and arrays reuse the factorization
+	const NUDTTK::LeastSquares<> solver{ NUDTTK::Matrix<double, Eigen::ColMajor>(mt_a) };
+	double y[30], x[10];
+	for (size_t i = 0; i < 30; i++)
+		y[i] = value_b[i * 2];
+	solver.Solve(y, x);
+	EXPECT_NEAR(x[9], 1.0, 1e-3);
+	EXPECT_NEAR(solver.Solve(NUDTTK::Vector<double>(30, y)).GetElement(3), 1.0, 1e-3);
+	EXPECT_EQ(solver.Solve(NUDTTK::Vector<double>(3)).GetSize(), 0);
+
+	// A rank deficient design has the minimum norm solution by COD
+	double value_c[] = { 1.0, 1.0, 2.0, 2.0, 3.0, 3.0 };
+	double value_y[] = { 2.0, 4.0, 6.0 };
+	const NUDTTK::LeastSquares<> rank_deficient(NUDTTK::Matrix<double>(3, 2, value_c), NUDTTK::LeastSquares<>::COD);
+	EXPECT_EQ(rank_deficient.GetRank(), 1);
+	EXPECT_FALSE(rank_deficient.IsFullRank());
+	NUDTTK::Vector<double> vt_x = rank_deficient.Solve(NUDTTK::Vector<double>(3, value_y));
+	EXPECT_NEAR(vt_x.GetElement(0), 1.0, 1e-12);
+	EXPECT_NEAR(vt_x.GetElement(1), 1.0, 1e-12);
+
+	// An empty design has rank 0 with every factorization
+	for (const NUDTTK::LeastSquares<>::Method method : methods) {
+		const NUDTTK::LeastSquares<> empty(NUDTTK::Matrix<double>(0, 3), method);
+		EXPECT_EQ(empty.GetRank(), 0);
+		EXPECT_FALSE(empty.IsFullRank());
+	}
+}
+TEST(randomized_svd, truncated_factors) {
+	// A 300 x 80 matrix of rank 8 plus noise of 1e-6
+	const NUDTTK::Matrix<double>::base_type value_x = NUDTTK::Matrix<double>::base_type::Random(300, 8);
+	const NUDTTK::Matrix<double>::base_type value_y = NUDTTK::Matrix<double>::base_type::Random(8, 80);
+	const NUDTTK::Matrix<double>::base_type value_e = NUDTTK::Matrix<double>::base_type::Random(300, 80);
+	const NUDTTK::Matrix<double> mt_a(NUDTTK::Matrix<double>::base_type(value_x * value_y + 1e-6 * value_e));
+	NUDTTK::Vector<double> vt_s;
+	NUDTTK::Matrix<double> mt_u, mt_v;
+	ASSERT_TRUE(mt_a.Svd(9, vt_s, mt_u, mt_v));
+
+	const NUDTTK::RandomizedSvd<> svd(mt_a, 8);
+	ASSERT_TRUE(svd.IsValid());
+	ASSERT_EQ(svd.GetSingularValues().GetSize(), 8);
+	EXPECT_EQ(svd.GetU().GetNumRows(), 300);
+	EXPECT_EQ(svd.GetV().GetNumRows(), 80);
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_NEAR(svd.GetSingularValues().GetElement(i), vt_s.GetElement(i), 1e-9 * vt_s.GetElement(0));
+
+	// The error estimate bounds the truncation error, the 9th singular value, and is not far above it
+	const NUDTTK::Matrix<double>::base_type value_r = mt_a.unwrap() - svd.GetU().unwrap() *
+		svd.GetSingularValues().unwrap().asDiagonal() * svd.GetV().unwrap().transpose();
+	const double error = NUDTTK::Matrix<double>(value_r).Svd(1, vt_s, mt_u, mt_v) ? vt_s.GetElement(0) : 0.0;
+	EXPECT_GT(error, 0.0);
+	EXPECT_GE(svd.GetErrorEstimate(), error);
+	EXPECT_LT(svd.GetErrorEstimate(), 1e3 * error);
+
+	// Orthonormal factors
+	const NUDTTK::Matrix<double>::base_type value_i = svd.GetU().unwrap().transpose() * svd.GetU().unwrap();
+	EXPECT_TRUE(value_i.isIdentity(1e-12));
+
+	EXPECT_FALSE(NUDTTK::RandomizedSvd<>(mt_a, 0).IsValid());
+	EXPECT_FALSE(NUDTTK::RandomizedSvd<>(mt_a, 81).IsValid());
+}
+TEST(matrix_exponential, pade_scaling_and_squaring) {
+	// Rotation exp([0 1; -1 0] t), large steps are scaled and squared
+	double value_r[] = { 0.0, 1.0, -1.0, 0.0 };
+	const NUDTTK::MatrixExponential<double, 2> rotation(value_r);
+	const double steps[] = { 0.0, 1e-3, 0.1, 1.0, 10.0, -25.0 };
+	double batch[6 * 4];
+	rotation.Evaluate(steps, 6, batch);
+	for (size_t k = 0; k < 6; k++) {
+		EXPECT_NEAR(batch[k * 4], std::cos(steps[k]), 1e-13);
+		EXPECT_NEAR(batch[k * 4 + 1], std::sin(steps[k]), 1e-13);
+		EXPECT_NEAR(batch[k * 4 + 2], -std::sin(steps[k]), 1e-13);
+		EXPECT_NEAR(batch[k * 4 + 3], std::cos(steps[k]), 1e-13);
+	}
+
+	// State transition matrix of the linearized dynamics of a double integrator, [I I dt; 0 I]
+	NUDTTK::MatrixExponential<double, 6>::value_type value_a = NUDTTK::MatrixExponential<double, 6>::value_type::Zero();
+	value_a.topRightCorner<3, 3>().setIdentity();
+	const NUDTTK::MatrixExponential<double, 6> transition(value_a);
+	const NUDTTK::MatrixExponential<double, 6>::value_type value_phi = transition.Evaluate(60.0);
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 6; j++)
+			EXPECT_NEAR(value_phi(i, j), i == j ? 1.0 : j == i + 3 ? 60.0 : 0.0, 1e-12);
+	}
+
+	// A Matrix of a size at run time, exp(diag(d)) = diag(exp(d))
+	double value_d[] = { -2.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0, 3.0 };
+	const NUDTTK::Matrix<double> mt_e = NUDTTK::MatrixExp(NUDTTK::Matrix<double>(3, 3, value_d), 2.0);
+	EXPECT_NEAR(mt_e.GetElement(0, 0), std::exp(-4.0), 1e-15);
+	EXPECT_NEAR(mt_e.GetElement(1, 1), std::exp(1.0), 1e-13);
+	EXPECT_NEAR(mt_e.GetElement(2, 2), std::exp(6.0), 1e-10 * std::exp(6.0));
+	EXPECT_EQ(mt_e.GetElement(0, 1), 0.0);
+	EXPECT_EQ(NUDTTK::MatrixExp(NUDTTK::Matrix<double>(2, 3)).GetNumRows(), 0);
+}
+TEST(covariance, propagation) {
+	// Sizes on the stack and beyond, and a design matrix of m x n
+	const size_t sizes[][2] = { { 6, 6 }, { 3, 6 }, { 20, 20 }, { 4, 24 } };
+	for (const auto& size : sizes) {
+		const Eigen::Index m = static_cast<Eigen::Index>(size[0]), n = static_cast<Eigen::Index>(size[1]);
+		const NUDTTK::Matrix<double>::base_type value_f = NUDTTK::Matrix<double>::base_type::Random(m, n);
+		const NUDTTK::Matrix<double>::base_type value_l = NUDTTK::Matrix<double>::base_type::Random(n, n);
+		const NUDTTK::Matrix<double>::base_type value_r = NUDTTK::Matrix<double>::base_type::Random(m, m);
+		const NUDTTK::Matrix<double>::base_type value_p = value_l * value_l.transpose();
+		const NUDTTK::Matrix<double>::base_type value_q = value_r * value_r.transpose();
+		const NUDTTK::Matrix<double>::base_type value_e = value_f * value_p * value_f.transpose() + value_q;
+
+		// The upper triangles are not read
+		NUDTTK::Matrix<double>::base_type value_pl = value_p, value_ql = value_q;
+		value_pl.triangularView<Eigen::StrictlyUpper>().setConstant(1e30);
+		value_ql.triangularView<Eigen::StrictlyUpper>().setConstant(1e30);
+		const NUDTTK::Matrix<double> mt_f(value_f), mt_p(value_pl);
+		NUDTTK::Matrix<double> mt_q(value_ql);
+		NUDTTK::Matrix<double> mt_out;
+		ASSERT_TRUE(NUDTTK::Covariance<>::Propagate(mt_out, mt_f, mt_p, mt_q));
+		EXPECT_TRUE(mt_out.unwrap().isApprox(value_e, 1e-12));
+		EXPECT_TRUE(mt_out.unwrap() == mt_out.unwrap().transpose());
+
+		// In place of q
+		ASSERT_TRUE(NUDTTK::Covariance<>::Propagate(mt_q, mt_f, mt_p, mt_q));
+		EXPECT_TRUE(mt_q.unwrap() == mt_out.unwrap());
+	}
+	NUDTTK::Matrix<double> mt_out;
+	EXPECT_FALSE(NUDTTK::Covariance<>::Propagate(mt_out, NUDTTK::Matrix<double>(3, 3), NUDTTK::Matrix<double>(2, 2),
+												 NUDTTK::Matrix<double>(3, 3)));
+
+	// A batch of objects on arrays, in place of P
+	const size_t count = 50;
+	std::vector<double> f(count * 36), p(count * 36), q(count * 36), expected(count * 36);
+	for (size_t k = 0; k < count; k++) {
+		const NUDTTK::Matrix<double>::base_type value_f = NUDTTK::Matrix<double>::base_type::Random(6, 6);
+		const NUDTTK::Matrix<double>::base_type value_l = NUDTTK::Matrix<double>::base_type::Random(6, 6);
+		const NUDTTK::Matrix<double>::base_type value_p = value_l * value_l.transpose();
+		const NUDTTK::Matrix<double>::base_type value_q = 1e-3 * NUDTTK::Matrix<double>::base_type::Identity(6, 6);
+		const NUDTTK::Matrix<double>::base_type value_e = value_f * value_p * value_f.transpose() + value_q;
+		std::copy(value_f.data(), value_f.data() + 36, f.begin() + k * 36);
+		std::copy(value_p.data(), value_p.data() + 36, p.begin() + k * 36);
+		std::copy(value_q.data(), value_q.data() + 36, q.begin() + k * 36);
+		std::copy(value_e.data(), value_e.data() + 36, expected.begin() + k * 36);
+	}
+	NUDTTK::Covariance<>::Propagate(f.data(), p.data(), q.data(), 6, 6, count, p.data());
+	for (size_t i = 0; i < count * 36; i++)
+		EXPECT_NEAR(p[i], expected[i], 1e-12 * std::fabs(expected[i]) + 1e-12);
+}
+TEST(result_cache, cross_instance_memoization) {
+	typedef NUDTTK::Matrix<double>::base_type base_type;
+	NUDTTK::ResultCache::SetBudget(1 << 20);
+	NUDTTK::ResultCache::Clear();
+	const base_type random = base_type::Random(20, 20);
+	const base_type value = random + 20.0 * base_type::Identity(20, 20);
+
+	// Equal matrices built apart share the results, other contents and storage orders do not
+	const NUDTTK::Matrix<double> mt_a(value), mt_b(value);
+	const NUDTTK::Matrix<double> mt_a_inv = mt_a.Inv();
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().misses, 1);
+	EXPECT_TRUE(mt_b.Inv().unwrap() == mt_a_inv.unwrap());
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().hits, 1);
+	EXPECT_DOUBLE_EQ(mt_a.DetGauss(), mt_b.DetGauss());
+	NUDTTK::Vector<double> values_a, values_b;
+	NUDTTK::Matrix<double> vectors_a, vectors_b;
+	ASSERT_TRUE(mt_a.Eigen(values_a, vectors_a));
+	ASSERT_TRUE(mt_b.Eigen(values_b, vectors_b));
+	EXPECT_TRUE(vectors_a.unwrap() == vectors_b.unwrap());
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().hits, 3);
+	NUDTTK::Matrix<double> mt_c(value);
+	mt_c.SetElement(3, 4, 0.5);
+	EXPECT_TRUE(mt_c.Inv().unwrap().isApprox(mt_c.unwrap().inverse()));
+	const NUDTTK::Matrix<double, Eigen::ColMajor> mt_col(mt_a);
+	EXPECT_TRUE(mt_col.Inv().unwrap().isApprox(mt_a_inv.unwrap()));
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().hits, 3);
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().entries, 5);
+
+	// Factorizations of identical design matrices, e.g. of windows
+	const base_type design = base_type::Random(50, 4);
+	const NUDTTK::Vector<double> observation(NUDTTK::Vector<double>::base_type(NUDTTK::Vector<double>::base_type::Random(50)));
+	const NUDTTK::LeastSquares<> solver_a(design.data(), 50, 4, NUDTTK::LeastSquares<>::QR);
+	const NUDTTK::LeastSquares<> solver_b(design.data(), 50, 4, NUDTTK::LeastSquares<>::QR);
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().hits, 4);
+	EXPECT_TRUE(solver_a.Solve(observation).unwrap() == solver_b.Solve(observation).unwrap());
+
+	// The least recently used results are evicted for the budget
+	NUDTTK::ResultCache::Clear();
+	NUDTTK::ResultCache::SetBudget(3 * 2 * 20 * 20 * sizeof(double));
+	const base_type others[] = { value + base_type::Identity(20, 20), value + 2.0 * base_type::Identity(20, 20) };
+	NUDTTK::Matrix<double>(value).Inv();
+	NUDTTK::Matrix<double>(others[0]).Inv();
+	NUDTTK::Matrix<double>(value).Inv();
+	NUDTTK::Matrix<double>(others[1]).Inv();
+	const NUDTTK::ResultCache::Usage usage = NUDTTK::ResultCache::GetUsage();
+	EXPECT_EQ(usage.hits, 1);
+	EXPECT_EQ(usage.evictions, 1);
+	EXPECT_EQ(usage.entries, 2);
+	EXPECT_LE(usage.bytes, usage.budget);
+	NUDTTK::Matrix<double>(value).Inv();
+	NUDTTK::Matrix<double>(others[0]).Inv();
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().hits, 2);
+
+	// Concurrent lookups of equal matrices
+	NUDTTK::ResultCache::SetBudget(1 << 20);
+	std::vector<std::thread> threads;
+	std::vector<NUDTTK::Matrix<double>> inverses(4);
+	for (size_t i = 0; i < inverses.size(); i++)
+		threads.emplace_back([&, i]() { inverses[i] = NUDTTK::Matrix<double>(others[i % 2]).Inv(); });
+	for (std::thread& thread : threads)
+		thread.join();
+	for (size_t i = 0; i < inverses.size(); i++)
+		EXPECT_TRUE(inverses[i].unwrap().isApprox(others[i % 2].inverse()));
+	NUDTTK::ResultCache::SetBudget(0);
+	EXPECT_EQ(NUDTTK::ResultCache::GetUsage().entries, 0);
+	NUDTTK::ResultCache::Clear();
+}
+
+TEST(algorithm_function, poly_fit) {
+	// A quadratic is reproduced by a fit of order 3
+	double x[] = { 0.0, 1.0, 2.5, 3.0, 4.5, 5.0 };
+	double y[6], y_fit[6];
+	for (size_t i = 0; i < 6; i++)
+		y[i] = 0.5 * x[i] * x[i] - 2.0 * x[i] + 1.0;
+
+	EXPECT_TRUE(NUDTTK::Math::PolyFit(x, y, 6, y_fit));
+	for (size_t i = 0; i < 6; i++) {
+		EXPECT_NEAR(y_fit[i], y[i], 1e-8);
+	}
+}
+TEST(algorithm_function, robust_poly_fit) {
+	// An outlier is edited out of a noisy quadratic
+	double x[20], y[20], w[20], y_fit[20];
+	for (size_t i = 0; i < 20; i++) {
+		x[i] = 0.5 * i;
+		y[i] = 0.5 * x[i] * x[i] - 2.0 * x[i] + 1.0 + 0.01 * std::sin(1.7 * i);
+	}
+	y[7] += 10.0;
+
+	EXPECT_TRUE(NUDTTK::Math::RobustPolyFit(x, y, w, 20, y_fit));
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(w[i], i == 7 ? 0.0 : 1.0);
+		if (i != 7) {
+			EXPECT_NEAR(y_fit[i], y[i], 0.05);
+		}
+	}
+}
+TEST(algorithm_function, vandrak_filter) {
+	// Third order differences of a quadratic vanish, the fit should reproduce the observations
+	double x[] = { 0.0, 1.0, 2.5, 3.0, 4.5, 5.0, 6.0, 7.5 };
+	double y[8], w[8], y_fit[8];
+	for (size_t i = 0; i < 8; i++) {
+		y[i] = 0.5 * x[i] * x[i] - 2.0 * x[i] + 1.0;
+		w[i] = 1.0;
+	}
+
+	EXPECT_TRUE(NUDTTK::Math::VandrakFilter(x, y, w, 8, 1e-6, y_fit));
+	for (size_t i = 0; i < 8; i++) {
+		EXPECT_NEAR(y_fit[i], y[i], 1e-8);
+	}
+}
+
+TEST(instrumentation, operation_and_cache_statistics) {
+	double value[] = { -2.0, 1.0, 4.0, -3.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+	NUDTTK::Instrumentation::Reset();
+	mt.Inv();
+	mt.Inv();
+	NUDTTK::Instrumentation::Snapshot snapshot = NUDTTK::Instrumentation::TakeSnapshot();
+
+	if (NUDTTK::Instrumentation::Enabled()) {
+		EXPECT_EQ(snapshot.Operation("Matrix::Inv").calls, 2);
+		EXPECT_EQ(snapshot.Cache("inverse_value").hits, 1);
+		EXPECT_EQ(snapshot.Cache("inverse_value").misses, 1);
+		EXPECT_DOUBLE_EQ(snapshot.Cache("inverse_value").HitRate(), 0.5);
+	} else {
+		EXPECT_TRUE(snapshot.operations.empty());
+		EXPECT_TRUE(snapshot.caches.empty());
+	}
+}
+
+class entry_point_counter : public NUDTTK::Instrumentation::AllocationObserver {
+public:
+	virtual void OnAllocation(const char* entry_point, std::size_t bytes) {
+		if (std::string(entry_point) == "Math::Mad")
+			mad_bytes += bytes;
+	}
+
+	size_t mad_bytes = 0;
+};
+
+TEST(instrumentation, allocation_tracking) {
+	double value[] = { -2.0, 1.0, 4.0, -3.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+	NUDTTK::Instrumentation::Reset();
+	mt.Inv();
+	mt.Max();
+	NUDTTK::Instrumentation::Snapshot snapshot = NUDTTK::Instrumentation::TakeSnapshot();
+
+	if (NUDTTK::Instrumentation::Enabled()) {
+		NUDTTK::Instrumentation::AllocationStats inv = snapshot.Allocation("Matrix::Inv");
+		EXPECT_EQ(inv.calls, 1);
+		EXPECT_GT(inv.allocations, 0);
+		EXPECT_GE(inv.bytes, 4 * sizeof(double));
+		EXPECT_EQ(inv.max_call_bytes, inv.bytes);
+		// Steady state, no heap allocation at all
+		EXPECT_EQ(snapshot.Allocation("Matrix::Max").calls, 1);
+		EXPECT_EQ(snapshot.Allocation("Matrix::Max").allocations, 0);
+		// Fixed-size values live on the stack
+		NUDTTK::Instrumentation::Reset();
+		const NUDTTK::MatrixExponential<double, 4> exponential(NUDTTK::MatrixExponential<double, 4>::value_type::Identity());
+		EXPECT_NEAR(exponential.Evaluate(0.5)(0, 0), std::exp(0.5), 1e-12);
+		const NUDTTK::Instrumentation::AllocationStats fixed =
+			NUDTTK::Instrumentation::TakeSnapshot().Allocation("MatrixExponential::Evaluate");
+		EXPECT_EQ(fixed.calls, 1);
+		EXPECT_EQ(fixed.allocations, 0);
+		EXPECT_EQ(fixed.bytes, 0);
+
+		entry_point_counter counter;
+		NUDTTK::Instrumentation::AllocationObserver* previous = NUDTTK::Instrumentation::SetAllocationObserver(&counter);
+		double data[] = { 1.0, 2.0, 3.0, 4.0, 100.0 };
+		NUDTTK::Math::Mad(data, 5);
+		EXPECT_EQ(NUDTTK::Instrumentation::SetAllocationObserver(previous), &counter);
+		EXPECT_GE(counter.mad_bytes, 5 * sizeof(double));
+	} else {
+		EXPECT_TRUE(snapshot.allocations.empty());
+		EXPECT_EQ(NUDTTK::Instrumentation::SetAllocationObserver(nullptr), nullptr);
+	}
+}
+
+TEST(instrumentation, chrome_trace) {
+	double value[] = { -2.0, 1.0, 4.0, -3.0 };
+	NUDTTK::Matrix<double> mt(2, value);
+	NUDTTK::Instrumentation::ClearTrace();
+	NUDTTK::Instrumentation::StartTracing();
+	mt.Inv();
+	std::thread worker([]() {
+		double data[] = { 3.0, 1.0, 2.0 };
+		NUDTTK::Math::Median(data, 3);
+	});
+	worker.join();
+	NUDTTK::Instrumentation::StopTracing();
+	mt.Max();
+
+	std::ostringstream os;
+	NUDTTK::Instrumentation::WriteChromeTrace(os);
+	const std::string trace = os.str();
+	EXPECT_NE(trace.find("\"traceEvents\":["), std::string::npos);
+	if (NUDTTK::Instrumentation::Enabled()) {
+		EXPECT_NE(trace.find("\"name\":\"Matrix::Inv\""), std::string::npos);
+		EXPECT_NE(trace.find("\"name\":\"Math::Median\""), std::string::npos);
+		EXPECT_EQ(trace.find("\"name\":\"Matrix::Max\""), std::string::npos);
+	} else {
+		EXPECT_EQ(trace.find("\"ph\":\"X\""), std::string::npos);
+	}
+
+	// Written while a thread keeps overwriting its ring buffer, every span kept is complete
+	NUDTTK::Instrumentation::ClearTrace();
+	NUDTTK::Instrumentation::StartTracing(16);
+	std::atomic<bool> done(false);
+	std::thread producer([&]() {
+		double data[] = { 3.0, 1.0, 2.0 };
+		while (!done.load())
+			NUDTTK::Math::Median(data, 3);
+	});
+	for (int i = 0; i < 20; i++) {
+		std::ostringstream concurrent;
+		NUDTTK::Instrumentation::WriteChromeTrace(concurrent);
+		EXPECT_EQ(concurrent.str().find("\"name\":\"\""), std::string::npos);
+	}
+	done.store(true);
+	producer.join();
+	NUDTTK::Instrumentation::StopTracing();
+	NUDTTK::Instrumentation::ClearTrace();
+}